@@ -0,0 +1,264 @@
+//
+//  TAffineModel.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TAffineModel.hpp"
+#include "TCommandLine.hpp"
+
+#include <stdlib.h>
+#include <stdexcept>
+
+#include <gsl/gsl_blas.h>
+
+using namespace std;
+
+const unsigned int TAffineModel::CONDUCTIVITY;
+const unsigned int TAffineModel::CONVECTIVITY;
+const unsigned int TAffineModel::FLUX;
+
+/**
+ * The pieces are integrated here once, with unit material properties and
+ * unit condition values, from the elements and the loaded boundary edges
+ **/
+TAffineModel::TAffineModel(map<size_t, TElement*> &connectivities, map<size_t, SMaterial> &materials,
+                           vector<SConditionGroup> &groups, TBoundary *edges, size_t size)
+    : size(size), connectivities(connectivities), groups(groups), K(NULL), F(NULL), solver(NULL) {
+    base.materials = materials;
+    map<size_t, vector<pair<size_t, TScalar> > > nodeGroups;   // (group, weight) by node id
+    fixed.assign(size, false);
+    for (size_t g = 0; g < groups.size(); g++) {
+        base.values.push_back(groups[g].value);
+        if (!groups[g].uniform && !groups[g].weights.empty())
+            throw runtime_error("ERROR: The condition block " + to_string(g + 1) + " has different values, the reduced model needs one value by block.");
+        map<size_t, TScalar>::iterator it;
+        for (it = groups[g].weights.begin(); it != groups[g].weights.end(); it++) {
+            nodeGroups[it->first].push_back(make_pair(g, it->second));
+            if (groups[g].type == "Temperature") fixed[it->first - 1] = true;
+        }
+    }
+    K = new TSparseMatrix(connectivities, size);
+    F = gsl_vector_alloc(size);
+    
+    // Elements: k = 1, the fixed temperature columns go to the loads
+    map<size_t, TElement*>::iterator it;
+    for (it = this->connectivities.begin(); it != this->connectivities.end(); it++) {
+        TElement *OElement = it->second;
+        size_t material = OElement->getMaterialId();
+        TSparseMatrix *Km = getMatrix(conductivity, material);
+        gsl_matrix *ke = OElement->getKd(1);
+        vector<size_t> nodeIds = OElement->getNodeIds();
+        for (size_t j = 0; j < nodeIds.size(); j++) {
+            size_t nodeJ = nodeIds[j] - 1;
+            if (fixed[nodeJ]) continue;
+            for (size_t k = 0; k < nodeIds.size(); k++) {
+                size_t nodeK = nodeIds[k] - 1;
+                if (!fixed[nodeK]) {
+                    Km->add(nodeJ, nodeK, gsl_matrix_get(ke, j, k));
+                    continue;
+                }
+                vector<pair<size_t, TScalar> > &shares = nodeGroups[nodeIds[k]];
+                for (size_t s = 0; s < shares.size(); s++) {
+                    gsl_vector *piece = getPiece(CONDUCTIVITY, material, shares[s].first);
+                    gsl_vector_set(piece, nodeJ, gsl_vector_get(piece, nodeJ) + shares[s].second * gsl_matrix_get(ke, j, k));
+                }
+            }
+        }
+        gsl_matrix_free(ke);
+    }
+    
+    // Convection edges: h = 1, h L / 6 [2 1; 1 2] and h L / 2 Ta at each node (see TBoundary)
+    SEdgeList &convection = edges->getEdges(TBoundary::CONVECTION);
+    for (size_t e = 0; e < convection.first.size(); e++) {
+        size_t material = convection.material[e];
+        size_t nodes[2] = {convection.first[e], convection.second[e]};
+        TSparseMatrix *Hm = getMatrix(convectivity, material);
+        TScalar km = convection.length[e] / 6;
+        Hm->add(nodes[0] - 1, nodes[0] - 1, 2 * km);
+        Hm->add(nodes[0] - 1, nodes[1] - 1, km);
+        Hm->add(nodes[1] - 1, nodes[0] - 1, km);
+        Hm->add(nodes[1] - 1, nodes[1] - 1, 2 * km);
+        for (size_t j = 0; j < 2; j++) {
+            vector<pair<size_t, TScalar> > &shares = nodeGroups[nodes[j]];
+            for (size_t s = 0; s < shares.size(); s++) {
+                gsl_vector *piece = getPiece(CONVECTIVITY, material, shares[s].first);
+                gsl_vector_set(piece, nodes[j] - 1, gsl_vector_get(piece, nodes[j] - 1) + shares[s].second * convection.length[e] / 2);
+            }
+        }
+    }
+    
+    // Flux edges: q L / 2 at each node
+    SEdgeList &flux = edges->getEdges(TBoundary::FLUX);
+    for (size_t e = 0; e < flux.first.size(); e++) {
+        size_t nodes[2] = {flux.first[e], flux.second[e]};
+        for (size_t j = 0; j < 2; j++) {
+            vector<pair<size_t, TScalar> > &shares = nodeGroups[nodes[j]];
+            for (size_t s = 0; s < shares.size(); s++) {
+                gsl_vector *piece = getPiece(FLUX, 0, shares[s].first);
+                gsl_vector_set(piece, nodes[j] - 1, gsl_vector_get(piece, nodes[j] - 1) + shares[s].second * flux.length[e] / 2);
+            }
+        }
+    }
+}
+
+TAffineModel::~TAffineModel() {
+    map<size_t, TSparseMatrix*>::iterator it;
+    for (it = conductivity.begin(); it != conductivity.end(); it++) delete it->second;
+    for (it = convectivity.begin(); it != convectivity.end(); it++) delete it->second;
+    for (size_t p = 0; p < pieces.size(); p++) gsl_vector_free(pieces[p].vector);
+    delete K;
+    if (F != NULL) gsl_vector_free(F);
+    delete solver;
+}
+
+gsl_vector * TAffineModel::getPiece(unsigned int kind, size_t material, size_t group) {
+    tuple<unsigned int, size_t, size_t> key(kind, material, group);
+    map<tuple<unsigned int, size_t, size_t>, size_t>::iterator found = pieceIndex.find(key);
+    if (found != pieceIndex.end()) return pieces[found->second].vector;
+    SAffinePiece OPiece;
+    OPiece.kind     = kind;
+    OPiece.material = material;
+    OPiece.group    = group;
+    OPiece.vector   = gsl_vector_alloc(size); gsl_vector_set_all(OPiece.vector, 0);
+    pieceIndex[key] = pieces.size();
+    pieces.push_back(OPiece);
+    return OPiece.vector;
+}
+
+/**
+ * A copy of the (empty) pattern of K for each material
+ **/
+TSparseMatrix * TAffineModel::getMatrix(map<size_t, TSparseMatrix*> &matrices, size_t material) {
+    map<size_t, TSparseMatrix*>::iterator found = matrices.find(material);
+    if (found != matrices.end()) return found->second;
+    TSparseMatrix *matrix = new TSparseMatrix(*K);
+    matrices[material] = matrix;
+    return matrix;
+}
+
+/**
+ * Full solution of the parameters, the solver is analyzed on the first one
+ * and factorized again for each
+ **/
+void TAffineModel::solve(SParameters &parameters, gsl_vector *A) {
+    K->setAll(0);
+    map<size_t, TSparseMatrix*>::iterator it;
+    for (it = conductivity.begin(); it != conductivity.end(); it++) K->addScaled(it->second, parameters.materials[it->first].conductivity);
+    for (it = convectivity.begin(); it != convectivity.end(); it++) K->addScaled(it->second, parameters.materials[it->first].convectivity);
+    for (size_t i = 0; i < size; i++) if (fixed[i]) K->add(i, i, 1);
+    
+    gsl_vector_set_all(F, 0);
+    for (size_t p = 0; p < pieces.size(); p++) gsl_blas_daxpy(getCoefficient(pieces[p], parameters), pieces[p].vector, F);
+    setFixed(groups, parameters, F);
+    
+    if (solver == NULL) {
+        string solverName = TCommandLine::getOption("solver", "auto");
+        if (solverName == "auto") solverName = TLinearSolver::selectAuto(K);
+        solver = TLinearSolver::create(solverName);
+        if (solver == NULL) throw runtime_error("ERROR: Unknown solver " + solverName + ".");
+        SSolverOptions solverOptions;
+        solverOptions.tolerance     = TCommandLine::getOption("tolerance", 1e-10);
+        solverOptions.maxIterations = (size_t)TCommandLine::getOption("max-iterations", 0.0);
+        solverOptions.subdomains    = (size_t)TCommandLine::getOption("subdomains", 0.0);
+        solverOptions.overlap       = (size_t)TCommandLine::getOption("overlap", 1.0);
+        solver->setOptions(solverOptions);
+        solver->setMesh(connectivities);
+        solver->analyze(K);
+    }
+    solver->factorize(K);
+    solver->solve(F, A);
+}
+
+/**
+ * Fixed temperatures of the parameters (node id - 1), the other values are kept
+ **/
+void TAffineModel::setFixed(vector<SConditionGroup> &groups, SParameters &parameters, gsl_vector *A) {
+    for (size_t g = 0; g < groups.size(); g++) {
+        if (groups[g].type != "Temperature") continue;
+        map<size_t, TScalar>::iterator it;
+        for (it = groups[g].weights.begin(); it != groups[g].weights.end(); it++) gsl_vector_set(A, it->first - 1, 0);
+    }
+    for (size_t g = 0; g < groups.size(); g++) {
+        if (groups[g].type != "Temperature") continue;
+        map<size_t, TScalar>::iterator it;
+        for (it = groups[g].weights.begin(); it != groups[g].weights.end(); it++)
+            gsl_vector_set(A, it->first - 1, gsl_vector_get(A, it->first - 1) + it->second * parameters.values[g]);
+    }
+}
+
+size_t TAffineModel::getSize() {
+    return size;
+}
+
+bool TAffineModel::isFixed(size_t i) {
+    return fixed[i];
+}
+
+SParameters TAffineModel::getBase() {
+    return base;
+}
+
+vector<SConditionGroup> & TAffineModel::getGroups() {
+    return groups;
+}
+
+vector<SAffinePiece> & TAffineModel::getPieces() {
+    return pieces;
+}
+
+map<size_t, TSparseMatrix*> & TAffineModel::getConductivity() {
+    return conductivity;
+}
+
+map<size_t, TSparseMatrix*> & TAffineModel::getConvectivity() {
+    return convectivity;
+}
+
+TLinearSolver * TAffineModel::getSolver() {
+    return solver;
+}
+
+TScalar TAffineModel::getCoefficient(SAffinePiece &piece, SParameters &parameters) {
+    if (piece.kind == CONDUCTIVITY) return -parameters.materials[piece.material].conductivity * parameters.values[piece.group];
+    if (piece.kind == CONVECTIVITY) return parameters.materials[piece.material].convectivity * parameters.values[piece.group];
+    return parameters.values[piece.group];
+}
+
+/**
+ * "k<material>=<value> h<material>=<value> b<block>=<value>" in the units of
+ * the input file, the parameters not given keep their base value
+ **/
+SParameters TAffineModel::parseParameters(string line, SParameters base, vector<SConditionGroup> &groups, size_t factor) {
+    vector<string> tmp = TSString::split(line, " \t\r");
+    for (size_t i = 0; i < tmp.size(); i++) {
+        size_t equal = tmp[i].find('=');
+        size_t index = (equal != string::npos && equal > 1) ? (size_t)atol(tmp[i].substr(1, equal - 1).c_str()) : 0;
+        TScalar value = (equal != string::npos) ? atof(tmp[i].substr(equal + 1).c_str()) : 0;
+        char name = tmp[i][0];
+        if ((name == 'k' || name == 'h') && base.materials.find(index) != base.materials.end()) {
+            if (name == 'k') base.materials[index].conductivity = value / factor;
+            else base.materials[index].convectivity = value / (factor * factor);
+        } else if (name == 'b' && index >= 1 && index <= groups.size()) {
+            base.values[index - 1] = (groups[index - 1].type == "Flux") ? value * factor : value;
+        } else {
+            throw runtime_error("ERROR: Wrong parameter \"" + tmp[i] + "\", use k<material>=, h<material>= or b<block>=.");
+        }
+    }
+    return base;
+}
@@ -0,0 +1,112 @@
+//
+//  TAffineModel.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TAffineModel_hpp
+#define TAffineModel_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
+
+#include <gsl/gsl_vector.h>
+
+#include "TElement.hpp"
+#include "TInputParser.hpp"
+#include "TBoundary.hpp"
+#include "TSparseMatrix.hpp"
+#include "TLinearSolver.hpp"
+
+/**
+ * Parameters of a problem on a fixed mesh: the material properties and the
+ * value of every condition block (file order), in the units of the parser
+ **/
+struct SParameters {
+    std::map<size_t, SMaterial> materials;
+    std::vector<TScalar> values;
+};
+
+/**
+ * Load vector of the free nodes times one parameter product:
+ * CONDUCTIVITY  -k t   fixed temperature columns of the elements
+ * CONVECTIVITY   h t   ambient temperature of the convection edges
+ * FLUX           q     flux edges (no material)
+ **/
+struct SAffinePiece {
+    unsigned int kind;
+    size_t material;
+    size_t group;
+    gsl_vector *vector;
+};
+
+/**
+ * Full problem as an affine sum of parameter independent pieces
+ * K(p) = sum k_m K_m + sum h_m H_m (+ identity rows of the fixed nodes)
+ * F(p) = sum coefficient(p) F_piece (+ fixed temperatures)
+ * Each K_m and H_m is built once (unit conductivity and convectivity) with
+ * the pattern of K, so solving new parameters only adds scaled values
+ * and factorizes again. The training sweeps of TReducedModel and its
+ * fallback solves go through here.
+ **/
+class TAffineModel {
+    private:
+        size_t size;
+        std::map<size_t, TElement*> connectivities;
+        std::vector<SConditionGroup> groups;
+        std::vector<bool> fixed;                        // by node id - 1
+        std::map<size_t, TSparseMatrix*> conductivity;  // free nodes only
+        std::map<size_t, TSparseMatrix*> convectivity;
+        std::vector<SAffinePiece> pieces;
+        std::map<std::tuple<unsigned int, size_t, size_t>, size_t> pieceIndex;
+        SParameters base;
+        TSparseMatrix *K;
+        gsl_vector *F;
+        TLinearSolver *solver;
+    
+        gsl_vector * getPiece(unsigned int kind, size_t material, size_t group);
+        TSparseMatrix * getMatrix(std::map<size_t, TSparseMatrix*> &matrices, size_t material);
+    
+    public:
+        static const unsigned int CONDUCTIVITY = 0;
+        static const unsigned int CONVECTIVITY = 1;
+        static const unsigned int FLUX = 2;
+    
+        TAffineModel(std::map<size_t, TElement*> &connectivities, std::map<size_t, SMaterial> &materials,
+                     std::vector<SConditionGroup> &groups, TBoundary *edges, size_t size);
+        virtual ~TAffineModel();
+    
+        void solve(SParameters &parameters, gsl_vector *A);
+        size_t getSize();
+        bool isFixed(size_t i);
+        SParameters getBase();
+        std::vector<SConditionGroup> & getGroups();
+        std::vector<SAffinePiece> & getPieces();
+        std::map<size_t, TSparseMatrix*> & getConductivity();
+        std::map<size_t, TSparseMatrix*> & getConvectivity();
+        TLinearSolver * getSolver();
+    
+        static TScalar getCoefficient(SAffinePiece &piece, SParameters &parameters);
+        static void setFixed(std::vector<SConditionGroup> &groups, SParameters &parameters, gsl_vector *A);
+        static SParameters parseParameters(std::string line, SParameters base, std::vector<SConditionGroup> &groups, size_t factor);
+};
+
+#endif /* TAffineModel_hpp */
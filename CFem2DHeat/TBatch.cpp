@@ -0,0 +1,221 @@
+//
+//  TBatch.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TBatch.hpp"
+#include "TCommandLine.hpp"
+#include "TLinearSolver.hpp"
+#include "TMemoryPlanner.hpp"
+#include "TThreadPool.hpp"
+#include "TSString.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+TBatch::TBatch(string program, string path) : program(program), path(path), time(0) {
+    cores = TThreadPool::getDefaultThreads();
+    double budget = TCommandLine::getOption("batch-memory", 0.0);
+    memoryBudget = (budget > 0) ? (size_t)(budget * 1024 * 1024) : TLinearSolver::getAvailableMemory();
+    
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) throw runtime_error("ERROR: Cannot open the batch " + path + ".");
+    if (S_ISDIR(info.st_mode)) readDirectory();
+    else readManifest();
+}
+
+TBatch::~TBatch() { }
+
+/**
+ * Relative problem names are relative to the manifest
+ **/
+void TBatch::readManifest() {
+    ifstream inFile(path.c_str());
+    if (!inFile.is_open()) throw runtime_error("ERROR: Cannot open the batch " + path + ".");
+    size_t slash = path.rfind('/');
+    string directory = (slash == string::npos) ? "" : path.substr(0, slash + 1);
+    string line;
+    while (getline(inFile, line)) {
+        vector<string> tmp = TSString::split(line, " ");
+        vector<string> fields;
+        for (size_t i = 0; i < tmp.size(); i++) if (!tmp[i].empty()) fields.push_back(tmp[i]);
+        if (fields.empty() || fields[0][0] == '#') continue;
+        string name = (fields[0][0] == '/') ? fields[0] : directory + fields[0];
+        addJob(name, vector<string>(fields.begin() + 1, fields.end()));
+    }
+}
+
+void TBatch::readDirectory() {
+    DIR *folder = opendir(path.c_str());
+    if (folder == NULL) throw runtime_error("ERROR: Cannot open the batch " + path + ".");
+    string directory = (path.back() == '/') ? path : path + "/";
+    vector<string> names;
+    struct dirent *entry;
+    while ((entry = readdir(folder)) != NULL) {
+        string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".dat") == 0) names.push_back(directory + name);
+    }
+    closedir(folder);
+    sort(names.begin(), names.end());
+    for (size_t n = 0; n < names.size(); n++) addJob(names[n], vector<string>());
+}
+
+void TBatch::addJob(string name, vector<string> options) {
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".dat") == 0) name = name.substr(0, name.size() - 4);
+    SBatchJob job;
+    job.name        = name;
+    job.options     = options;
+    job.nodes       = job.elements = 0;
+    job.pid         = 0;
+    job.exitCode    = -1;
+    job.time        = 0;
+    estimate(job);
+    jobs.push_back(job);
+}
+
+/**
+ * Size of the problem from the amounts line of its input file, that gives
+ * its threads and its memory estimate for the solver it is going to use
+ * (rounded up to MB, it is given to the problem as --max-memory)
+ **/
+void TBatch::estimate(SBatchJob &job) {
+    const size_t MB = 1024 * 1024;
+    TMemoryPlanner::readAmounts(job.name + ".dat", job.elements, job.nodes);
+    TMemoryPlanner planner(job.nodes, job.elements);
+    string solver = TCommandLine::getOption("solver", "auto");
+    for (size_t o = 0; o < job.options.size(); o++) {
+        if (job.options[o].compare(0, 9, "--solver=") == 0) solver = job.options[o].substr(9);
+    }
+    job.threads     = (unsigned int)max((size_t)1, min((size_t)cores, job.nodes / NODES_PER_THREAD));
+    job.memory      = planner.estimate(solver);
+    job.outOfCore   = job.memory > memoryBudget;
+    if (job.outOfCore) {
+        size_t smallest = planner.estimateOutOfCore(TMemoryPlanner::MIN_BUDGET);
+        job.memory = min(planner.estimateOutOfCore(256 * MB), max(memoryBudget / 2, smallest));
+    }
+    job.memory      = (job.memory + MB - 1) / MB * MB;
+}
+
+void TBatch::start(SBatchJob &job) {
+    vector<string> args;
+    args.push_back(program);
+    args.push_back(job.name);
+    map<string, string> options = TCommandLine::getOptions();
+    options.erase("batch");
+    options.erase("batch-memory");
+    options["no-server"] = "";
+    options["threads"] = to_string(job.threads);
+    options["max-memory"] = to_string(job.memory / 1024 / 1024);
+    if (job.outOfCore) options["out-of-core"] = "";
+    map<string, string>::iterator it;
+    for (it = options.begin(); it != options.end(); it++) args.push_back("--" + it->first + (it->second.empty() ? "" : "=" + it->second));
+    const char *verbosity[] = {"", "-v", "-vv", "-vvv"};
+    if (TCommandLine::getVerbosityLevel() > 0) args.push_back(verbosity[min(TCommandLine::getVerbosityLevel(), 3u)]);
+    args.insert(args.end(), job.options.begin(), job.options.end()); // the manifest ones win
+    
+    job.begin = chrono::steady_clock::now();
+    job.pid = fork();
+    if (job.pid < 0) throw runtime_error("ERROR: Cannot start the problem " + job.name + ".");
+    if (job.pid == 0) {
+        int log = open((job.name + ".log").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log >= 0) {
+            dup2(log, STDOUT_FILENO);
+            dup2(log, STDERR_FILENO);
+            close(log);
+        }
+        vector<char *> argv;
+        for (size_t a = 0; a < args.size(); a++) argv.push_back((char *)args[a].c_str());
+        argv.push_back(NULL);
+        execvp(program.c_str(), argv.data());
+        _exit(127);
+    }
+}
+
+/**
+ * Running every problem, 0 if all of them were solved
+ **/
+int TBatch::run() {
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    vector<size_t> waiting(jobs.size());
+    for (size_t j = 0; j < jobs.size(); j++) waiting[j] = j;
+    stable_sort(waiting.begin(), waiting.end(), [&](size_t a, size_t b) { return jobs[a].nodes > jobs[b].nodes; });
+    
+    unsigned int freeCores = cores;
+    size_t usedMemory = 0, running = 0;
+    while (!waiting.empty() || running > 0) {
+        // Largest first, so a big problem is never starved by the small ones after it
+        while (!waiting.empty()) {
+            SBatchJob &job = jobs[waiting.front()];
+            bool fits = job.threads <= freeCores && usedMemory + job.memory <= memoryBudget;
+            if (!fits && running > 0) break;
+            start(job);
+            freeCores -= min(job.threads, freeCores);
+            usedMemory += job.memory;
+            running++;
+            waiting.erase(waiting.begin());
+        }
+        
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0) break;
+        for (size_t j = 0; j < jobs.size(); j++) {
+            SBatchJob &job = jobs[j];
+            if (job.pid != pid) continue;
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - job.begin;
+            job.time        = elapsed.count();
+            job.exitCode    = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+            job.pid         = 0;
+            freeCores += job.threads;
+            freeCores = min(freeCores, cores);
+            usedMemory -= job.memory;
+            running--;
+            if (TCommandLine::getVerbosityLevel() >= 1) {
+                cout << "Problem " << job.name << " exit code (" << job.exitCode << ") time (" << job.time << "s)" << endl;
+            }
+        }
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+    time = elapsed.count();
+    
+    for (size_t j = 0; j < jobs.size(); j++) if (jobs[j].exitCode != 0) return 1;
+    return 0;
+}
+
+void TBatch::printSummary(ostream &out) {
+    size_t failed = 0;
+    for (size_t j = 0; j < jobs.size(); j++) {
+        SBatchJob &job = jobs[j];
+        out << "Problem " << job.name << " nodes (" << job.nodes << ") threads (" << job.threads << ")";
+        if (job.outOfCore) out << " out of core";
+        out << " time (" << job.time << "s) exit code (" << job.exitCode << ")" << endl;
+        if (job.exitCode != 0) failed++;
+    }
+    out << "Problems (" << jobs.size() << ") failed (" << failed << ") cores (" << cores << ")";
+    out << " time (" << time << "s) problems per second (" << (time > 0 ? jobs.size() / time : 0) << ")" << endl;
+}
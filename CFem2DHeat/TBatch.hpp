@@ -0,0 +1,86 @@
+//
+//  TBatch.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TBatch_hpp
+#define TBatch_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <sys/types.h>
+
+struct SBatchJob {
+    std::string name;                   // problem name (without .dat)
+    std::vector<std::string> options;   // its own options from the manifest
+    size_t nodes;
+    size_t elements;
+    unsigned int threads;
+    size_t memory;                      // estimated peak bytes
+    bool outOfCore;
+    pid_t pid;
+    int exitCode;
+    double time;
+    std::chrono::steady_clock::time_point begin;
+};
+
+/**
+ * Batch of problems (--batch=<manifest or directory>)
+ * The manifest has one problem per line with its own options if any
+ * ("name [--option=value ...]", # comments), a directory gives all its .dat files.
+ *
+ * Every problem runs as a child process of this same program (the input
+ * parser and the command line are process wide) with its output in
+ * <name>.log. The free cores go to the next waiting problem, largest first:
+ * a big problem gets several threads (--threads) and the small ones that
+ * follow take one core each as soon as it is free. A problem only starts when its
+ * estimated memory (TMemoryPlanner) fits in the budget (--batch-memory=<MB>,
+ * the available memory by default), the ones that can never fit run out of
+ * core with at most half of it. Every problem gets its share as --max-memory
+ * so it plans its solve to stay inside it.
+ * The options of the batch command line are given to every problem.
+ **/
+class TBatch {
+    private:
+        std::string program;
+        std::string path;
+        std::vector<SBatchJob> jobs;
+        unsigned int cores;
+        size_t memoryBudget;
+        double time;
+    
+        void readManifest();
+        void readDirectory();
+        void addJob(std::string name, std::vector<std::string> options);
+        void estimate(SBatchJob &job);
+        void start(SBatchJob &job);
+    
+    public:
+        static const size_t NODES_PER_THREAD = 50000;
+    
+        TBatch(std::string program, std::string path);
+        virtual ~TBatch();
+    
+        int run();
+        void printSummary(std::ostream &out);
+};
+
+#endif /* TBatch_hpp */
@@ -0,0 +1,98 @@
+//
+//  TBoundary.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TBoundary.hpp"
+
+using namespace std;
+
+TBoundary::TBoundary() { }
+
+TBoundary::~TBoundary() { }
+
+void TBoundary::addEdge(unsigned int type, size_t first, size_t second, TScalar length, TScalar coefficient, size_t material) {
+    SEdgeList &edges = (type == CONVECTION) ? convection : flux;
+    edges.first.push_back(first);
+    edges.second.push_back(second);
+    edges.length.push_back(length);
+    edges.coefficient.push_back(coefficient);
+    edges.material.push_back(material);
+    edges.firstValue.push_back(0);
+    edges.secondValue.push_back(0);
+}
+
+/**
+ * The condition values can change while the edges stay (cached models)
+ **/
+void TBoundary::setValues(map<size_t, SCondition> &conditions) {
+    for (size_t e = 0; e < convection.first.size(); e++) {
+        convection.firstValue[e]  = conditions[convection.first[e]].ambient;
+        convection.secondValue[e] = conditions[convection.second[e]].ambient;
+    }
+    for (size_t e = 0; e < flux.first.size(); e++) {
+        flux.firstValue[e]  = conditions[flux.first[e]].flux;
+        flux.secondValue[e] = conditions[flux.second[e]].flux;
+    }
+}
+
+/**
+ * The edge contributions are computed in a flat loop and then scattered,
+ * F is written sequentially since the edges share nodes
+ **/
+void TBoundary::assembleF(SEdgeList &edges, gsl_vector *F) {
+    size_t amount = edges.first.size();
+    vector<TScalar> firstF(amount), secondF(amount);
+    const TScalar *length = edges.length.data(), *coefficient = edges.coefficient.data();
+    const TScalar *firstValue = edges.firstValue.data(), *secondValue = edges.secondValue.data();
+    for (size_t e = 0; e < amount; e++) {
+        TScalar scale = coefficient[e] * length[e] / 2;
+        firstF[e]  = scale * firstValue[e];
+        secondF[e] = scale * secondValue[e];
+    }
+    for (size_t e = 0; e < amount; e++) {
+        size_t i = edges.first[e] - 1, j = edges.second[e] - 1;
+        gsl_vector_set(F, i, gsl_vector_get(F, i) + firstF[e]);
+        gsl_vector_set(F, j, gsl_vector_get(F, j) + secondF[e]);
+    }
+}
+
+void TBoundary::assemble(gsl_vector *F, function<void(size_t, size_t, double)> addEntry) {
+    size_t amount = convection.first.size();
+    vector<TScalar> km(amount);
+    const TScalar *length = convection.length.data(), *coefficient = convection.coefficient.data();
+    for (size_t e = 0; e < amount; e++) km[e] = coefficient[e] * length[e] / 6;
+    for (size_t e = 0; e < amount; e++) {
+        size_t i = convection.first[e] - 1, j = convection.second[e] - 1;
+        addEntry(i, i, 2 * km[e]);
+        addEntry(i, j, km[e]);
+        addEntry(j, i, km[e]);
+        addEntry(j, j, 2 * km[e]);
+    }
+    assembleF(convection, F);
+    assembleF(flux, F);
+}
+
+size_t TBoundary::getAmountOfEdges(unsigned int type) {
+    return (type == CONVECTION) ? convection.first.size() : flux.first.size();
+}
+
+SEdgeList & TBoundary::getEdges(unsigned int type) {
+    return (type == CONVECTION) ? convection : flux;
+}
@@ -0,0 +1,80 @@
+//
+//  TBoundary.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TBoundary_hpp
+#define TBoundary_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <map>
+#include <functional>
+
+#include "TElement.hpp"
+
+/**
+ * Loaded edges of one kind with their data in flat arrays (edge e is the
+ * e-th entry of every array), values are the nodal condition values at
+ * both ends: the ambient temperature for convection and the flux for flux
+ **/
+struct SEdgeList {
+    std::vector<size_t> first;          // node ids
+    std::vector<size_t> second;
+    std::vector<TScalar> length;
+    std::vector<TScalar> coefficient;   // convectivity of the element material, 1 for flux
+    std::vector<size_t> material;       // of the element
+    std::vector<TScalar> firstValue;
+    std::vector<TScalar> secondValue;
+};
+
+/**
+ * Boundary edges loaded by the Line conditions (convection and flux)
+ * The GiD conditions are given by node, an edge is loaded when it belongs to
+ * a single element and both its nodes have the same Flux or Convection
+ * condition (see TInputParser::parseElement). Their integrals are assembled
+ * in a pass of their own so the elements only carry the conduction term:
+ * convection   K += h L / 6 * | 2 1 |   F += h L / 2 * | Ta1 |
+ *                             | 1 2 |                  | Ta2 |
+ * flux         F += L / 2 * | q1 |
+ *                           | q2 |
+ * An element with two loaded edges (a corner) gets both of them.
+ **/
+class TBoundary {
+    private:
+        SEdgeList convection;
+        SEdgeList flux;
+    
+        void assembleF(SEdgeList &edges, gsl_vector *F);
+    
+    public:
+        static const unsigned int CONVECTION = 0;
+        static const unsigned int FLUX = 1;
+    
+        TBoundary();
+        virtual ~TBoundary();
+    
+        void addEdge(unsigned int type, size_t first, size_t second, TScalar length, TScalar coefficient, size_t material);
+        void setValues(std::map<size_t, SCondition> &conditions);
+        void assemble(gsl_vector *F, std::function<void(size_t, size_t, double)> addEntry);
+        size_t getAmountOfEdges(unsigned int type);
+        SEdgeList & getEdges(unsigned int type);
+};
+
+#endif /* TBoundary_hpp */
@@ -0,0 +1,89 @@
+//
+//  TBoundedQueue.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TBoundedQueue_hpp
+#define TBoundedQueue_hpp
+
+#include <stdio.h>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/**
+ * Bounded FIFO between two pipeline stages
+ * push blocks while the queue is full and pop while it is empty. The time
+ * spent blocked is added to the given stall counter (in seconds) so every
+ * stage can tell how long it was waiting for its neighbours.
+ * close() ends the stream: pop returns false once the queue is drained and
+ * push returns false right away, so a failing stage never leaves the other
+ * one blocked.
+ **/
+template <typename T>
+class TBoundedQueue {
+    private:
+        std::deque<T> items;
+        size_t capacity;
+        bool closed;
+        std::mutex lock;
+        std::condition_variable notFull;
+        std::condition_variable notEmpty;
+    
+    public:
+        TBoundedQueue(size_t capacity) : capacity(capacity), closed(false) { }
+        virtual ~TBoundedQueue() { }
+    
+        bool push(const T &item, double &stall) {
+            std::unique_lock<std::mutex> guard(lock);
+            if (items.size() >= capacity && !closed) {
+                std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                notFull.wait(guard, [this] { return items.size() < capacity || closed; });
+                stall += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            }
+            if (closed) return false;
+            items.push_back(item);
+            notEmpty.notify_one();
+            return true;
+        }
+    
+        bool pop(T &item, double &stall) {
+            std::unique_lock<std::mutex> guard(lock);
+            if (items.empty() && !closed) {
+                std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                notEmpty.wait(guard, [this] { return !items.empty() || closed; });
+                stall += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            }
+            if (items.empty()) return false;
+            item = items.front();
+            items.pop_front();
+            notFull.notify_one();
+            return true;
+        }
+    
+        void close() {
+            std::unique_lock<std::mutex> guard(lock);
+            closed = true;
+            notFull.notify_all();
+            notEmpty.notify_all();
+        }
+};
+
+#endif /* TBoundedQueue_hpp */
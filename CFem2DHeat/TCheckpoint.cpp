@@ -0,0 +1,139 @@
+//
+//  TCheckpoint.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#include "TCheckpoint.hpp"
+#include "TResultCache.hpp"
+
+#include <fstream>
+
+using namespace std;
+
+static const char CHECKPOINT_MAGIC[8] = {'C', 'F', 'E', 'M', 'C', 'K', 'P', '1'};
+
+TCheckpoint::TCheckpoint(string fileName, size_t key, double interval, bool restart)
+    : fileName(fileName), key(key), interval(interval), restart(restart), resumed(false), last(chrono::steady_clock::now()), writing(false), written(0) { }
+
+TCheckpoint::~TCheckpoint() {
+    if (writer.joinable()) writer.join();
+}
+
+bool TCheckpoint::isDue() {
+    return chrono::duration<double>(chrono::steady_clock::now() - last).count() >= interval;
+}
+
+/**
+ * Copy of the state for the writer thread
+ **/
+void TCheckpoint::save(SCheckpointState &state) {
+    last = chrono::steady_clock::now();
+    if (writing.load()) return;
+    if (writer.joinable()) writer.join();
+    pending = state;
+    writing.store(true);
+    writer = thread(&TCheckpoint::write, this);
+}
+
+void TCheckpoint::write() {
+    string tmpName = fileName + ".tmp";
+    {
+        ofstream out(tmpName.c_str(), ios::binary);
+        auto putSize = [&](size_t value) { uint64_t v = value; out.write((const char *)&v, sizeof(v)); };
+        out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        putSize(key);
+        putSize(pending.solver.size()); out.write(pending.solver.data(), pending.solver.size());
+        putSize(pending.iterations);
+        putSize(pending.scalars.size());
+        out.write((const char *)pending.scalars.data(), pending.scalars.size() * sizeof(double));
+        putSize(pending.vectors.size());
+        for (size_t v = 0; v < pending.vectors.size(); v++) {
+            putSize(pending.vectors[v].size());
+            out.write((const char *)pending.vectors[v].data(), pending.vectors[v].size() * sizeof(double));
+        }
+        if (!out.good()) {
+            out.close();
+            remove(tmpName.c_str());
+            writing.store(false);
+            return;
+        }
+    }
+    if (rename(tmpName.c_str(), fileName.c_str()) == 0) written++;
+    writing.store(false);
+}
+
+/**
+ * The saved state when restarting from a checkpoint of this problem, solver
+ * and size, otherwise false (the solve starts from the beginning)
+ **/
+bool TCheckpoint::load(SCheckpointState &state, string solver, size_t size) {
+    if (!restart) return false;
+    restart = false; // only the first solve resumes
+    ifstream in(fileName.c_str(), ios::binary);
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    if (!in.is_open() || !in.read(magic, sizeof(magic)) || string(magic, sizeof(magic)) != string(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)))
+        return false;
+    auto getSize = [&]() { uint64_t v = 0; in.read((char *)&v, sizeof(v)); return (size_t)v; };
+    if (getSize() != key) return false;
+    state.solver.resize(getSize());
+    in.read(&state.solver[0], state.solver.size());
+    if (!in.good() || state.solver != solver) return false;
+    state.iterations = getSize();
+    state.scalars.resize(getSize());
+    in.read((char *)state.scalars.data(), state.scalars.size() * sizeof(double));
+    state.vectors.resize(getSize());
+    for (size_t v = 0; v < state.vectors.size() && in.good(); v++) {
+        if (getSize() != size) return false;
+        state.vectors[v].resize(size);
+        in.read((char *)state.vectors[v].data(), size * sizeof(double));
+    }
+    resumed = in.good();
+    return resumed;
+}
+
+/**
+ * Waiting for the last write, the finished solve needs no checkpoint
+ **/
+void TCheckpoint::finish() {
+    if (writer.joinable()) writer.join();
+    remove(fileName.c_str());
+}
+
+size_t TCheckpoint::getWritten() {
+    return written;
+}
+
+bool TCheckpoint::hasResumed() {
+    return resumed;
+}
+
+/**
+ * The key of the result (every section of the input file and the solver
+ * options, see TResultCache) and the name of the solver picked for it, so
+ * a restart never resumes under another solver or preconditioner
+ **/
+size_t TCheckpoint::getKey(map<unsigned int, size_t> sections, string solver) {
+    size_t key = TResultCache::getKey(sections);
+    for (size_t i = 0; i < solver.size(); i++) {
+        key ^= (unsigned char)solver[i];
+        key *= 1099511628211ULL;
+    }
+    return key;
+}
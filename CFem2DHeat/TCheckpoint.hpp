@@ -0,0 +1,85 @@
+//
+//  TCheckpoint.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#ifndef TCheckpoint_hpp
+#define TCheckpoint_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+/**
+ * State of an iterative solve: the iteration, its scalars and its vectors
+ * (conjugate gradient: rz and residual, x r p)
+ **/
+struct SCheckpointState {
+    std::string solver;
+    size_t iterations;
+    std::vector<double> scalars;
+    std::vector<std::vector<double> > vectors;
+};
+
+/**
+ * Checkpoints of a long iterative solve (--checkpoint[=<seconds>], --restart)
+ * Every interval the solver hands its state to save, which keeps a copy and
+ * returns, the copy is written by a background thread to <file>.tmp and
+ * renamed over <file> so the file on disk is always a complete checkpoint.
+ * A checkpoint still being written when the next one is due is not waited
+ * for, that one is skipped.
+ * The key of the problem (input file sections, solver options and solver)
+ * is saved with the state, a restart only takes a checkpoint of the same
+ * problem and solver.
+ **/
+class TCheckpoint {
+    private:
+        std::string fileName;
+        size_t key;
+        double interval;
+        bool restart;
+        bool resumed;
+        std::chrono::steady_clock::time_point last;
+        SCheckpointState pending;
+        std::thread writer;
+        std::atomic<bool> writing;
+        size_t written;
+    
+        void write();
+    
+    public:
+        TCheckpoint(std::string fileName, size_t key, double interval, bool restart);
+        virtual ~TCheckpoint();
+    
+        bool isDue();
+        void save(SCheckpointState &state);
+        bool load(SCheckpointState &state, std::string solver, size_t size);
+        void finish();
+        size_t getWritten();
+        bool hasResumed();
+    
+        static size_t getKey(std::map<unsigned int, size_t> sections, std::string solver);
+};
+
+#endif /* TCheckpoint_hpp */
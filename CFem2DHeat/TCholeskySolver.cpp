@@ -0,0 +1,176 @@
+//
+//  TCholeskySolver.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TCholeskySolver.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+#include "TSOrdering.hpp"
+
+using namespace std;
+
+const size_t NONE = (size_t)-1;
+
+template <typename T>
+TCholeskySolver<T>::TCholeskySolver() { }
+
+template <typename T>
+TCholeskySolver<T>::~TCholeskySolver() { }
+
+template <typename T>
+string TCholeskySolver<T>::getName() {
+    return sizeof(T) == sizeof(double) ? "cholesky" : "cholesky-single";
+}
+
+/**
+ * Non zero pattern of the row k of L
+ * Every entry of the column k of the upper triangle climbs the elimination
+ * tree until it finds an already marked node. The pattern is left in
+ * stack[top..size) and top is returned.
+ **/
+template <typename T>
+size_t TCholeskySolver<T>::reach(size_t k, vector<size_t> &mark, vector<size_t> &stack) {
+    size_t top = size;
+    mark[k] = k;
+    for (size_t p = Ap[k]; p < Ap[k + 1]; p++) {
+        size_t i = Ai[p];
+        if (i > k) continue;
+        size_t length = 0;
+        for (; mark[i] != k; i = parent[i]) {
+            stack[length++] = i;
+            mark[i] = k;
+        }
+        while (length > 0) stack[--top] = stack[--length];
+    }
+    return top;
+}
+
+/**
+ * Symbolic factorization
+ * Ordering, elimination tree and column counts of L
+ **/
+template <typename T>
+void TCholeskySolver<T>::analyze(TSparseMatrix *K) {
+    size = K->getSize();
+    vector<vector<size_t> > adjacency = K->getAdjacency();
+    order = TSOrdering::nestedDissection(adjacency);
+    
+    // Upper triangle of the renumbered K by columns
+    vector<size_t> counts(size + 1, 0);
+    for (size_t i = 0; i < size; i++)
+        for (size_t p = K->getRowStart(i); p < K->getRowStart(i + 1); p++)
+            if (order[i] <= order[K->getColumn(p)]) counts[order[K->getColumn(p)]]++;
+    Ap.assign(size + 1, 0);
+    for (size_t j = 0; j < size; j++) Ap[j + 1] = Ap[j] + counts[j];
+    Ai.resize(Ap[size]); Amap.resize(Ap[size]);
+    vector<size_t> next(Ap.begin(), Ap.end() - 1);
+    for (size_t i = 0; i < size; i++) {
+        for (size_t p = K->getRowStart(i); p < K->getRowStart(i + 1); p++) {
+            size_t r = order[i], c = order[K->getColumn(p)];
+            if (r > c) continue;
+            Ai[next[c]] = r; Amap[next[c]] = p; next[c]++;
+        }
+    }
+    
+    // Elimination tree
+    parent.assign(size, NONE);
+    vector<size_t> ancestor(size, NONE);
+    for (size_t k = 0; k < size; k++) {
+        for (size_t p = Ap[k]; p < Ap[k + 1]; p++) {
+            size_t i = Ai[p];
+            while (i != NONE && i < k) {
+                size_t inext = ancestor[i];
+                ancestor[i] = k;
+                if (inext == NONE) { parent[i] = k; break; }
+                i = inext;
+            }
+        }
+    }
+    
+    // Column counts from the row patterns
+    vector<size_t> mark(size, NONE), stack(size);
+    fill(counts.begin(), counts.end(), 1); // diagonal
+    for (size_t k = 0; k < size; k++) {
+        for (size_t top = reach(k, mark, stack); top < size; top++) counts[stack[top]]++;
+    }
+    Lp.assign(size + 1, 0);
+    for (size_t j = 0; j < size; j++) Lp[j + 1] = Lp[j] + counts[j];
+    Li.assign(Lp[size], 0);
+    Lx.assign(Lp[size], 0);
+}
+
+/**
+ * Up looking numeric factorization
+ * Row k of L solves L(0:k, 0:k) * l = K(0:k, k) over the pattern given by
+ * reach(k), then the diagonal is sqrt(K(k, k) - l * l).
+ **/
+template <typename T>
+void TCholeskySolver<T>::factorize(TSparseMatrix *K) {
+    vector<size_t> mark(size, NONE), stack(size);
+    vector<size_t> column(Lp.begin(), Lp.end() - 1);
+    vector<T> x(size, 0);
+    
+    for (size_t k = 0; k < size; k++) {
+        size_t top = reach(k, mark, stack);
+        x[k] = 0;
+        for (size_t p = Ap[k]; p < Ap[k + 1]; p++) x[Ai[p]] = K->getValue(Amap[p]);
+        T d = x[k]; x[k] = 0;
+        for (; top < size; top++) {
+            size_t i = stack[top];
+            T lki = x[i] / Lx[Lp[i]];
+            x[i] = 0;
+            for (size_t p = Lp[i] + 1; p < column[i]; p++) x[Li[p]] -= Lx[p] * lki;
+            d -= lki * lki;
+            size_t p = column[i]++;
+            Li[p] = k; Lx[p] = lki;
+        }
+        if (d <= 0) throw runtime_error("ERROR: Sparse matrix is not positive definite.");
+        size_t p = column[k]++;
+        Li[p] = k; Lx[p] = sqrt(d);
+    }
+}
+
+/**
+ * L * y = b and Lt * x = y in the renumbered system
+ **/
+template <typename T>
+void TCholeskySolver<T>::solve(gsl_vector *b, gsl_vector *x) {
+    vector<T> y(size);
+    for (size_t i = 0; i < size; i++) y[order[i]] = gsl_vector_get(b, i);
+    for (size_t j = 0; j < size; j++) {
+        y[j] /= Lx[Lp[j]];
+        for (size_t p = Lp[j] + 1; p < Lp[j + 1]; p++) y[Li[p]] -= Lx[p] * y[j];
+    }
+    for (size_t j = size; j-- > 0;) {
+        for (size_t p = Lp[j] + 1; p < Lp[j + 1]; p++) y[j] -= Lx[p] * y[Li[p]];
+        y[j] /= Lx[Lp[j]];
+    }
+    for (size_t i = 0; i < size; i++) gsl_vector_set(x, i, y[order[i]]);
+}
+
+template <typename T>
+size_t TCholeskySolver<T>::getFactorSize() {
+    return Lx.size();
+}
+
+template class TCholeskySolver<double>;
+template class TCholeskySolver<float>;
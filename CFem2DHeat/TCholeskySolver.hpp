@@ -0,0 +1,59 @@
+//
+//  TCholeskySolver.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TCholeskySolver_hpp
+#define TCholeskySolver_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "TLinearSolver.hpp"
+
+/**
+ * Sparse Cholesky K = L * Lt with nested dissection ordering
+ * L is stored by columns (CSC) with the diagonal first in each column.
+ * T is the precision of the factor and of its arithmetic (double or float),
+ * the solve interface is always double.
+ **/
+template <typename T>
+class TCholeskySolver : public TLinearSolver {
+    private:
+        std::vector<size_t> order;
+        std::vector<size_t> parent;
+        std::vector<size_t> Ap, Ai; // upper triangle of the renumbered K by columns
+        std::vector<size_t> Amap;   // K value index of each Ai entry
+        std::vector<size_t> Lp, Li;
+        std::vector<T> Lx;
+    
+        size_t reach(size_t k, std::vector<size_t> &mark, std::vector<size_t> &stack);
+    
+    public:
+        TCholeskySolver();
+        virtual ~TCholeskySolver();
+    
+        std::string getName();
+        void analyze(TSparseMatrix *K);
+        void factorize(TSparseMatrix *K);
+        void solve(gsl_vector *b, gsl_vector *x);
+        size_t getFactorSize();
+};
+
+#endif /* TCholeskySolver_hpp */
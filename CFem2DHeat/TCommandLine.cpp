@@ -0,0 +1,76 @@
+//
+//  TCommandLine.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TCommandLine.hpp"
+
+#include <stdlib.h>
+
+using namespace std;
+
+string TCommandLine::problemName;
+unsigned int TCommandLine::verbosityLevel;
+map<string, string> TCommandLine::options;
+
+void TCommandLine::parse(int argc, const char * argv[]) {
+    const map<string, unsigned int> verbosity = {{"-v", 1}, {"-vv", 2}, {"-vvv", 3}};
+    bool named      = argc > 1 && argv[1][0] != '-'; // CFem2DHeat --server has no problem
+    problemName     = named ? (string)argv[1] : "";
+    verbosityLevel  = 0;
+    options.clear();
+    for (int i = named ? 2 : 1; i < argc; i++) {
+        string arg = argv[i];
+        if (verbosity.find(arg) != verbosity.end()) {
+            verbosityLevel = verbosity.at(arg);
+        } else if (arg.compare(0, 2, "--") == 0) {
+            size_t equal = arg.find('=');
+            if (equal == string::npos) options[arg.substr(2)] = "";
+            else options[arg.substr(2, equal - 2)] = arg.substr(equal + 1);
+        }
+    }
+}
+
+string TCommandLine::getProblemName() {
+    return problemName;
+}
+
+unsigned int TCommandLine::getVerbosityLevel() {
+    return verbosityLevel;
+}
+
+bool TCommandLine::hasOption(string name) {
+    return options.find(name) != options.end();
+}
+
+string TCommandLine::getOption(string name, string defaultValue) {
+    return hasOption(name) ? options[name] : defaultValue;
+}
+
+double TCommandLine::getOption(string name, double defaultValue) {
+    return hasOption(name) && !options[name].empty() ? atof(options[name].c_str()) : defaultValue;
+}
+
+void TCommandLine::setOption(string name, string value) {
+    options[name] = value;
+}
+
+map<string, string> TCommandLine::getOptions() {
+    return options;
+}
@@ -0,0 +1,52 @@
+//
+//  TCommandLine.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TCommandLine_hpp
+#define TCommandLine_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+/**
+ * Command line contract:
+ * CFem2DHeat <problem name> [-v|-vv|-vvv] [--option=value] [--flag]
+ * The problem name is the input file without the .dat extension.
+ **/
+class TCommandLine {
+    private:
+        static std::string problemName;
+        static unsigned int verbosityLevel;
+        static std::map<std::string, std::string> options;
+    
+    public:
+        static void parse(int argc, const char * argv[]);
+        static std::string getProblemName();
+        static unsigned int getVerbosityLevel();
+        static bool hasOption(std::string name);
+        static std::string getOption(std::string name, std::string defaultValue = "");
+        static double getOption(std::string name, double defaultValue);
+        static void setOption(std::string name, std::string value);
+        static std::map<std::string, std::string> getOptions();
+};
+
+#endif /* TCommandLine_hpp */
@@ -0,0 +1,348 @@
+//
+//  TCondensation.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TCondensation.hpp"
+
+#include <math.h>
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+const size_t NONE = (size_t)-1;
+
+TCondensation::TCondensation(TSparseMatrix *K, map<size_t, TElement*> &connectivities, map<size_t, SCondition> &conditions, map<size_t, size_t> &substructures) : K(K), reducedK(NULL) {
+    findCopies(connectivities, conditions, substructures);
+    buildReducedMatrix();
+}
+
+TCondensation::~TCondensation() {
+    for (size_t s = 0; s < superelements.size(); s++) delete superelements[s];
+    delete reducedK;
+}
+
+/**
+ * Grouping the tagged elements in copies and building (or reusing) their superelements
+ **/
+void TCondensation::findCopies(map<size_t, TElement*> &connectivities, map<size_t, SCondition> &conditions, map<size_t, size_t> &substructures) {
+    size_t size = K->getSize();
+    
+    // Elements of every node and tagged elements of every node
+    vector<size_t> elementsOfNode(size, 0);
+    vector<vector<size_t> > taggedOfNode(size);
+    map<size_t, TElement*>::iterator it;
+    for (it = connectivities.begin(); it != connectivities.end(); it++) {
+        vector<size_t> nodeIds = it->second->getNodeIds();
+        bool tagged = substructures.find(it->first) != substructures.end();
+        for (size_t j = 0; j < nodeIds.size(); j++) {
+            elementsOfNode[nodeIds[j] - 1]++;
+            if (tagged) taggedOfNode[nodeIds[j] - 1].push_back(it->first);
+        }
+    }
+    
+    copyOf.assign(size, NONE);
+    map<size_t, bool> visited;
+    map<string, vector<size_t> > candidates; // superelements of each signature
+    map<size_t, size_t>::iterator st;
+    for (st = substructures.begin(); st != substructures.end(); st++) {
+        if (visited[st->first] || connectivities.find(st->first) == connectivities.end()) continue;
+        
+        // Elements with the same substructure id connected by their nodes
+        vector<TElement *> elements;
+        vector<size_t> stack(1, st->first);
+        visited[st->first] = true;
+        while (!stack.empty()) {
+            TElement *OElement = connectivities[stack.back()]; stack.pop_back();
+            elements.push_back(OElement);
+            vector<size_t> nodeIds = OElement->getNodeIds();
+            for (size_t j = 0; j < nodeIds.size(); j++) {
+                vector<size_t> &next = taggedOfNode[nodeIds[j] - 1];
+                for (size_t k = 0; k < next.size(); k++) {
+                    if (visited[next[k]] || substructures[next[k]] != st->second) continue;
+                    visited[next[k]] = true;
+                    stack.push_back(next[k]);
+                }
+            }
+        }
+        
+        // Interior nodes only belong to the copy and have no fixed temperature
+        map<size_t, size_t> elementsInCopy;
+        for (size_t e = 0; e < elements.size(); e++) {
+            vector<size_t> nodeIds = elements[e]->getNodeIds();
+            for (size_t j = 0; j < nodeIds.size(); j++) elementsInCopy[nodeIds[j] - 1]++;
+        }
+        vector<size_t> interior, boundary;
+        map<size_t, size_t>::iterator nt;
+        for (nt = elementsInCopy.begin(); nt != elementsInCopy.end(); nt++) {
+            bool fixed = conditions.find(nt->first + 1) != conditions.end() && conditions[nt->first + 1].type == "Temperature";
+            if (nt->second == elementsOfNode[nt->first] && !fixed) interior.push_back(nt->first);
+            else boundary.push_back(nt->first);
+        }
+        if (interior.empty()) continue;
+        
+        // Reusing the superelement of a previous copy with the same signature and shape
+        // Kii moves with the positions by about tolerance / shortest edge
+        SCopyShape shape;
+        vector<size_t> &sameSignature = candidates[getSignature(elements, interior, boundary, conditions, shape)];
+        size_t s = NONE;
+        for (size_t k = 0; k < sameSignature.size() && s == NONE; k++) {
+            SCopyShape &reference = shapes[sameSignature[k]];
+            if (!sameShape(shape, reference)) continue;
+            double tolerance = max(1e-8, 4 * max(shape.tolerance, reference.tolerance) / min(shape.shortestEdge, reference.shortestEdge));
+            if (superelements[sameSignature[k]]->matches(K, interior, boundary.size(), tolerance)) s = sameSignature[k];
+        }
+        if (s != NONE) {
+            superelements[s]->addCopy();
+        } else {
+            map<size_t, size_t> boundaryIndex;
+            for (size_t b = 0; b < boundary.size(); b++) boundaryIndex[boundary[b]] = b;
+            gsl_matrix *Kib = gsl_matrix_alloc(interior.size(), boundary.size()); gsl_matrix_set_all(Kib, 0);
+            for (size_t i = 0; i < interior.size(); i++) {
+                for (size_t p = K->getRowStart(interior[i]); p < K->getRowStart(interior[i] + 1); p++) {
+                    map<size_t, size_t>::iterator found = boundaryIndex.find(K->getColumn(p));
+                    if (found != boundaryIndex.end()) gsl_matrix_set(Kib, i, found->second, K->getValue(p));
+                }
+            }
+            TSparseMatrix *Kii = K->getSubmatrix(interior);
+            s = superelements.size();
+            superelements.push_back(new TSuperelement(Kii, Kib));
+            shapes.push_back(shape);
+            sameSignature.push_back(s);
+            delete Kii;
+            gsl_matrix_free(Kib);
+        }
+        
+        for (size_t i = 0; i < interior.size(); i++) copyOf[interior[i]] = interiors.size();
+        interiors.push_back(interior);
+        boundaries.push_back(boundary);
+        superelementOf.push_back(s);
+    }
+}
+
+/**
+ * Translation invariant description of a copy
+ * The input file has 6 significant digits (GiD writes %14.5e), so a node
+ * position measured from the corner of the bounding box is known within
+ * 1e-5 of the largest coordinate of the copy. The interior and boundary
+ * nodes are sorted by position with that tolerance, so copies with the same
+ * signature list their nodes in the same order whatever their numbering in
+ * the mesh is, and the positions are left in the shape to be compared.
+ **/
+string TCondensation::getSignature(vector<TElement *> &elements, vector<size_t> &interior, vector<size_t> &boundary, map<size_t, SCondition> &conditions, SCopyShape &shape) {
+    map<size_t, SNode> coordinates;
+    shape.shortestEdge = HUGE_VAL;
+    for (size_t e = 0; e < elements.size(); e++) {
+        map<size_t, SNode>::iterator nt;
+        for (nt = elements[e]->nodes.begin(); nt != elements[e]->nodes.end(); nt++) coordinates[nt->first - 1] = nt->second;
+        vector<size_t> nodeIds = elements[e]->getNodeIds();
+        for (size_t j = 0; j < nodeIds.size(); j++) {
+            SNode &a = elements[e]->nodes[nodeIds[j]], &b = elements[e]->nodes[nodeIds[(j + 1) % nodeIds.size()]];
+            shape.shortestEdge = min(shape.shortestEdge, (double)hypot(b.x - a.x, b.y - a.y));
+        }
+    }
+    
+    TScalar minX = coordinates.begin()->second.x, maxX = minX, minY = coordinates.begin()->second.y, maxY = minY;
+    double largest = 0;
+    map<size_t, SNode>::iterator nt;
+    for (nt = coordinates.begin(); nt != coordinates.end(); nt++) {
+        minX = min(minX, nt->second.x); maxX = max(maxX, nt->second.x);
+        minY = min(minY, nt->second.y); maxY = max(maxY, nt->second.y);
+        largest = max(largest, (double)max(fabs(nt->second.x), fabs(nt->second.y)));
+    }
+    double tolerance = max(2e-5 * largest, 1e-6 * (double)max(maxX - minX, maxY - minY));
+    if (tolerance <= 0) tolerance = 1;
+    shape.tolerance = tolerance;
+    
+    map<size_t, SNode> position;
+    for (nt = coordinates.begin(); nt != coordinates.end(); nt++) {
+        position[nt->first].x = nt->second.x - minX;
+        position[nt->first].y = nt->second.y - minY;
+    }
+    auto byPosition = [&position, tolerance](size_t a, size_t b) {
+        SNode &pa = position[a], &pb = position[b];
+        if (fabs(pa.x - pb.x) > tolerance) return pa.x < pb.x;
+        if (fabs(pa.y - pb.y) > tolerance) return pa.y < pb.y;
+        return a < b;
+    };
+    sort(interior.begin(), interior.end(), byPosition);
+    sort(boundary.begin(), boundary.end(), byPosition);
+    
+    ostringstream signature;
+    map<size_t, size_t> local;
+    shape.positions.clear();
+    signature << interior.size() << " " << boundary.size();
+    for (size_t k = 0; k < interior.size() + boundary.size(); k++) {
+        size_t node = k < interior.size() ? interior[k] : boundary[k - interior.size()];
+        local[node] = k;
+        shape.positions.push_back(position[node]);
+        signature << " " << (conditions.find(node + 1) != conditions.end() ? conditions[node + 1].type : "-");
+    }
+    
+    vector<vector<size_t> > topology;
+    for (size_t e = 0; e < elements.size(); e++) {
+        vector<size_t> nodeIds = elements[e]->getNodeIds();
+        vector<size_t> element;
+        for (size_t j = 0; j < nodeIds.size(); j++) element.push_back(local[nodeIds[j] - 1]);
+        sort(element.begin(), element.end());
+        element.push_back(elements[e]->getMaterialId());
+        topology.push_back(element);
+    }
+    sort(topology.begin(), topology.end());
+    for (size_t e = 0; e < topology.size(); e++) {
+        signature << " |";
+        for (size_t j = 0; j < topology[e].size(); j++) signature << " " << topology[e][j];
+    }
+    return signature.str();
+}
+
+/**
+ * Same node positions within the larger tolerance of the two copies
+ **/
+bool TCondensation::sameShape(SCopyShape &a, SCopyShape &b) {
+    if (a.positions.size() != b.positions.size()) return false;
+    double tolerance = max(a.tolerance, b.tolerance);
+    for (size_t k = 0; k < a.positions.size(); k++) {
+        if (fabs(a.positions[k].x - b.positions[k].x) > tolerance || fabs(a.positions[k].y - b.positions[k].y) > tolerance) return false;
+    }
+    return true;
+}
+
+/**
+ * Kr = Krr - sum(C) over the untagged and boundary nodes
+ **/
+void TCondensation::buildReducedMatrix() {
+    size_t size = K->getSize();
+    vector<size_t> reducedIndex(size, NONE);
+    reducedNodes.clear();
+    for (size_t i = 0; i < size; i++) {
+        if (copyOf[i] != NONE) continue;
+        reducedIndex[i] = reducedNodes.size();
+        reducedNodes.push_back(i);
+    }
+    
+    vector<vector<size_t> > rows(reducedNodes.size());
+    for (size_t r = 0; r < reducedNodes.size(); r++) {
+        for (size_t p = K->getRowStart(reducedNodes[r]); p < K->getRowStart(reducedNodes[r] + 1); p++)
+            if (reducedIndex[K->getColumn(p)] != NONE) rows[r].push_back(reducedIndex[K->getColumn(p)]);
+    }
+    for (size_t c = 0; c < boundaries.size(); c++) {
+        for (size_t a = 0; a < boundaries[c].size(); a++)
+            for (size_t b = 0; b < boundaries[c].size(); b++) rows[reducedIndex[boundaries[c][a]]].push_back(reducedIndex[boundaries[c][b]]);
+    }
+    reducedK = new TSparseMatrix(rows);
+    
+    for (size_t r = 0; r < reducedNodes.size(); r++) {
+        for (size_t p = K->getRowStart(reducedNodes[r]); p < K->getRowStart(reducedNodes[r] + 1); p++)
+            if (reducedIndex[K->getColumn(p)] != NONE) reducedK->add(r, reducedIndex[K->getColumn(p)], K->getValue(p));
+    }
+    for (size_t c = 0; c < boundaries.size(); c++) {
+        TSuperelement *OSuperelement = superelements[superelementOf[c]];
+        for (size_t a = 0; a < boundaries[c].size(); a++)
+            for (size_t b = 0; b < boundaries[c].size(); b++)
+                reducedK->add(reducedIndex[boundaries[c][a]], reducedIndex[boundaries[c][b]], -OSuperelement->getCorrection(a, b));
+    }
+}
+
+TSparseMatrix * TCondensation::getReducedMatrix() {
+    return reducedK;
+}
+
+/**
+ * Fr = Fr - sum(Kbi Kii^-1 Fi)
+ * A neighbour of an interior node that is not interior of the same copy
+ * is one of its boundary nodes.
+ **/
+gsl_vector * TCondensation::condense(gsl_vector *F) {
+    gsl_vector *condensedF = gsl_vector_alloc(F->size); gsl_vector_memcpy(condensedF, F);
+    for (size_t c = 0; c < interiors.size(); c++) {
+        vector<size_t> &interior = interiors[c];
+        gsl_vector *fi = gsl_vector_alloc(interior.size());
+        gsl_vector *yi = gsl_vector_alloc(interior.size());
+        for (size_t i = 0; i < interior.size(); i++) gsl_vector_set(fi, i, gsl_vector_get(F, interior[i]));
+        superelements[superelementOf[c]]->solveInterior(fi, yi);
+        for (size_t i = 0; i < interior.size(); i++) {
+            for (size_t p = K->getRowStart(interior[i]); p < K->getRowStart(interior[i] + 1); p++) {
+                size_t j = K->getColumn(p);
+                if (copyOf[j] == c) continue;
+                gsl_vector_set(condensedF, j, gsl_vector_get(condensedF, j) - K->getValue(p) * gsl_vector_get(yi, i));
+            }
+        }
+        gsl_vector_free(fi);
+        gsl_vector_free(yi);
+    }
+    
+    gsl_vector *reducedF = gsl_vector_alloc(reducedNodes.size());
+    for (size_t r = 0; r < reducedNodes.size(); r++) gsl_vector_set(reducedF, r, gsl_vector_get(condensedF, reducedNodes[r]));
+    gsl_vector_free(condensedF);
+    return reducedF;
+}
+
+/**
+ * Back substitution of the interior temperatures: Ai = Kii^-1 (Fi - Kib Ab)
+ **/
+void TCondensation::recover(gsl_vector *reducedA, gsl_vector *F, gsl_vector *A) {
+    for (size_t r = 0; r < reducedNodes.size(); r++) gsl_vector_set(A, reducedNodes[r], gsl_vector_get(reducedA, r));
+    for (size_t c = 0; c < interiors.size(); c++) {
+        vector<size_t> &interior = interiors[c];
+        gsl_vector *fi = gsl_vector_alloc(interior.size());
+        gsl_vector *ai = gsl_vector_alloc(interior.size());
+        for (size_t i = 0; i < interior.size(); i++) {
+            double value = gsl_vector_get(F, interior[i]);
+            for (size_t p = K->getRowStart(interior[i]); p < K->getRowStart(interior[i] + 1); p++) {
+                size_t j = K->getColumn(p);
+                if (copyOf[j] != c) value -= K->getValue(p) * gsl_vector_get(A, j);
+            }
+            gsl_vector_set(fi, i, value);
+        }
+        superelements[superelementOf[c]]->solveInterior(fi, ai);
+        for (size_t i = 0; i < interior.size(); i++) gsl_vector_set(A, interior[i], gsl_vector_get(ai, i));
+        gsl_vector_free(fi);
+        gsl_vector_free(ai);
+    }
+}
+
+/**
+ * The reduced unknowns of a full vector (an initial guess for the reduced system)
+ **/
+void TCondensation::restrict(gsl_vector *A, gsl_vector *reducedA) {
+    for (size_t r = 0; r < reducedNodes.size(); r++) gsl_vector_set(reducedA, r, gsl_vector_get(A, reducedNodes[r]));
+}
+
+size_t TCondensation::getAmountOfCopies() {
+    return interiors.size();
+}
+
+size_t TCondensation::getAmountOfSuperelements() {
+    return superelements.size();
+}
+
+size_t TCondensation::getReducedSize() {
+    return reducedNodes.size();
+}
+
+/**
+ * Values stored by the superelements (interior factors and C)
+ **/
+size_t TCondensation::getFactorSize() {
+    size_t values = 0;
+    for (size_t s = 0; s < superelements.size(); s++) values += superelements[s]->getFactorSize();
+    return values;
+}
@@ -0,0 +1,95 @@
+//
+//  TCondensation.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TCondensation_hpp
+#define TCondensation_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <gsl/gsl_vector.h>
+
+#include "TSparseMatrix.hpp"
+#include "TSuperelement.hpp"
+
+/**
+ * Node positions of a copy from its bounding box corner, in the order of its
+ * signature (interior nodes first), and how far two positions can be apart
+ * and still be the same one
+ **/
+struct SCopyShape {
+    std::vector<SNode> positions;
+    double tolerance;
+    double shortestEdge;
+};
+
+/**
+ * Static condensation of repeated substructures
+ * Elements are tagged with a substructure id in the input file and every
+ * connected group of elements with the same id is one copy. The nodes of a
+ * copy that only belong to its elements (and have no fixed temperature) are
+ * interior, the rest are boundary nodes.
+ *
+ * Copies are compared by a signature of their topology, materials and node
+ * conditions, and then by their node positions relative to their bounding
+ * box corner (so translated copies match) within the print precision of
+ * the input file. Matching copies share one superelement, the Schur
+ * complement is computed only once.
+ *
+ * Only the boundary and untagged nodes enter the reduced system:
+ *   Kr = Krr - sum(C)        Fr = Fr - sum(Kbi Kii^-1 Fi)
+ * and the interior temperatures are recovered afterwards:
+ *   Ai = Kii^-1 (Fi - Kib Ab)
+ **/
+class TCondensation {
+    private:
+        TSparseMatrix *K;
+        TSparseMatrix *reducedK;
+        std::vector<std::vector<size_t> > interiors;    // interior nodes of each copy (superelement order)
+        std::vector<std::vector<size_t> > boundaries;   // boundary nodes of each copy (superelement order)
+        std::vector<size_t> superelementOf;             // superelement of each copy
+        std::vector<TSuperelement *> superelements;
+        std::vector<SCopyShape> shapes;                 // shape of the copy that built each superelement
+        std::vector<size_t> copyOf;                     // copy of each interior node
+        std::vector<size_t> reducedNodes;               // node of each reduced unknown
+    
+        void findCopies(std::map<size_t, TElement*> &connectivities, std::map<size_t, SCondition> &conditions, std::map<size_t, size_t> &substructures);
+        std::string getSignature(std::vector<TElement *> &elements, std::vector<size_t> &interior, std::vector<size_t> &boundary, std::map<size_t, SCondition> &conditions, SCopyShape &shape);
+        bool sameShape(SCopyShape &a, SCopyShape &b);
+        void buildReducedMatrix();
+    
+    public:
+        TCondensation(TSparseMatrix *K, std::map<size_t, TElement*> &connectivities, std::map<size_t, SCondition> &conditions, std::map<size_t, size_t> &substructures);
+        virtual ~TCondensation();
+    
+        TSparseMatrix * getReducedMatrix();
+        gsl_vector * condense(gsl_vector *F);
+        void recover(gsl_vector *reducedA, gsl_vector *F, gsl_vector *A);
+        void restrict(gsl_vector *A, gsl_vector *reducedA);
+        size_t getAmountOfCopies();
+        size_t getAmountOfSuperelements();
+        size_t getReducedSize();
+        size_t getFactorSize();
+};
+
+#endif /* TCondensation_hpp */
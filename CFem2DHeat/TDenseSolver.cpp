@@ -0,0 +1,56 @@
+//
+//  TDenseSolver.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TDenseSolver.hpp"
+
+using namespace std;
+
+TDenseSolver::TDenseSolver() : L(NULL) { }
+
+TDenseSolver::~TDenseSolver() {
+    delete L;
+}
+
+string TDenseSolver::getName() {
+    return "dense";
+}
+
+void TDenseSolver::analyze(TSparseMatrix *K) {
+    size = K->getSize();
+    delete L;
+    L = new TPackedMatrix(size);
+}
+
+void TDenseSolver::factorize(TSparseMatrix *K) {
+    L->allocate();
+    for (size_t i = 0; i < size; i++)
+        for (size_t p = K->getRowStart(i); p < K->getRowStart(i + 1); p++)
+            if (i <= K->getColumn(p)) L->add(i, K->getColumn(p), K->getValue(p));
+    L->factorize();
+}
+
+void TDenseSolver::solve(gsl_vector *b, gsl_vector *x) {
+    L->solve(b, x);
+}
+
+size_t TDenseSolver::getFactorSize() {
+    return L ? L->getProfileSize() : 0;
+}
@@ -0,0 +1,48 @@
+//
+//  TDenseSolver.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TDenseSolver_hpp
+#define TDenseSolver_hpp
+
+#include <stdio.h>
+
+#include "TLinearSolver.hpp"
+#include "TPackedMatrix.hpp"
+
+/**
+ * Dense Cholesky on the packed upper triangle of K
+ **/
+class TDenseSolver : public TLinearSolver {
+    private:
+        TPackedMatrix *L;
+    
+    public:
+        TDenseSolver();
+        virtual ~TDenseSolver();
+    
+        std::string getName();
+        void analyze(TSparseMatrix *K);
+        void factorize(TSparseMatrix *K);
+        void solve(gsl_vector *b, gsl_vector *x);
+        size_t getFactorSize();
+};
+
+#endif /* TDenseSolver_hpp */
@@ -0,0 +1,196 @@
+//
+//  TDiskMatrix.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TDiskMatrix.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+using namespace std;
+
+static bool byPosition(const STriplet &a, const STriplet &b) {
+    return a.row != b.row ? a.row < b.row : a.column < b.column;
+}
+
+/**
+ * Half of the budget goes to the assembly buffer, an eighth to the streamed block
+ **/
+TDiskMatrix::TDiskMatrix(string path, size_t size, size_t memoryBudget) : size(size), memoryBudget(memoryBudget), path(path), file(-1), entries(NULL), mappedBytes(0) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    blockBytes = max(page, (memoryBudget / 8) / page * page);
+    buffer.reserve(max((size_t)1, memoryBudget / 2 / sizeof(STriplet)));
+}
+
+TDiskMatrix::~TDiskMatrix() {
+    if (entries != NULL) munmap(entries, mappedBytes);
+    if (file >= 0) close(file);
+    for (size_t r = 0; r < runs.size(); r++) remove(runs[r].c_str());
+    remove(path.c_str());
+}
+
+void TDiskMatrix::add(size_t i, size_t j, double value) {
+    if (entries != NULL) throw runtime_error("ERROR: The disk matrix is already finalized.");
+    STriplet OTriplet = { i, j, value };
+    buffer.push_back(OTriplet);
+    if (buffer.size() == buffer.capacity()) spill();
+}
+
+/**
+ * Sorted run with the duplicates already added
+ **/
+void TDiskMatrix::spill() {
+    if (buffer.empty()) return;
+    sort(buffer.begin(), buffer.end(), byPosition);
+    size_t last = 0;
+    for (size_t k = 1; k < buffer.size(); k++) {
+        if (buffer[k].row == buffer[last].row && buffer[k].column == buffer[last].column) buffer[last].value += buffer[k].value;
+        else buffer[++last] = buffer[k];
+    }
+    
+    string runPath = path + ".run" + to_string(runs.size());
+    FILE *run = fopen(runPath.c_str(), "wb");
+    if (run == NULL || fwrite(&buffer[0], sizeof(STriplet), last + 1, run) != last + 1) {
+        if (run != NULL) fclose(run);
+        throw runtime_error("ERROR: Cannot write the out of core file " + runPath + ".");
+    }
+    fclose(run);
+    runs.push_back(runPath);
+    buffer.clear();
+}
+
+/**
+ * K-way merge of the runs into the entries file
+ **/
+void TDiskMatrix::merge() {
+    vector<FILE *> inputs(runs.size());
+    vector<STriplet> heads(runs.size());
+    auto later = [&heads](size_t a, size_t b) { return byPosition(heads[b], heads[a]); };
+    priority_queue<size_t, vector<size_t>, decltype(later)> next(later);
+    for (size_t r = 0; r < runs.size(); r++) {
+        inputs[r] = fopen(runs[r].c_str(), "rb");
+        if (inputs[r] == NULL) throw runtime_error("ERROR: Cannot read the out of core file " + runs[r] + ".");
+        if (fread(&heads[r], sizeof(STriplet), 1, inputs[r]) == 1) next.push(r);
+    }
+    
+    FILE *output = fopen(path.c_str(), "wb");
+    if (output == NULL) throw runtime_error("ERROR: Cannot write the out of core file " + path + ".");
+    rowStart.assign(size + 1, 0);
+    bool pending = false;
+    STriplet current = { 0, 0, 0 };
+    size_t written = 0;
+    while (!next.empty() || pending) {
+        bool done = next.empty();
+        STriplet head = done ? current : heads[next.top()];
+        if (!done) {
+            size_t r = next.top(); next.pop();
+            if (fread(&heads[r], sizeof(STriplet), 1, inputs[r]) == 1) next.push(r);
+        }
+        if (pending && !done && head.row == current.row && head.column == current.column) {
+            current.value += head.value;
+            continue;
+        }
+        if (pending) {
+            SDiskEntry OEntry = { current.column, current.value };
+            if (fwrite(&OEntry, sizeof(SDiskEntry), 1, output) != 1) throw runtime_error("ERROR: Cannot write the out of core file " + path + ".");
+            rowStart[current.row + 1] = ++written;
+        }
+        current = head;
+        pending = !done;
+    }
+    fclose(output);
+    for (size_t r = 0; r < runs.size(); r++) {
+        fclose(inputs[r]);
+        remove(runs[r].c_str());
+    }
+    
+    // Empty rows start where the previous one ends
+    for (size_t i = 1; i <= size; i++) rowStart[i] = max(rowStart[i], rowStart[i - 1]);
+}
+
+void TDiskMatrix::mapEntries() {
+    mappedBytes = rowStart[size] * sizeof(SDiskEntry);
+    if (mappedBytes == 0) return;
+    file = open(path.c_str(), O_RDONLY);
+    void *address = (file < 0) ? MAP_FAILED : mmap(NULL, mappedBytes, PROT_READ, MAP_SHARED, file, 0);
+    if (address == MAP_FAILED) throw runtime_error("ERROR: Cannot map the out of core file " + path + ".");
+    entries = (SDiskEntry *)address;
+    madvise(entries, mappedBytes, MADV_SEQUENTIAL);
+}
+
+/**
+ * Last spill, merge and map of the matrix
+ **/
+void TDiskMatrix::finalize() {
+    spill();
+    vector<STriplet>().swap(buffer);
+    merge();
+    mapEntries();
+}
+
+double TDiskMatrix::get(size_t i, size_t j) {
+    SDiskEntry *first = entries + rowStart[i];
+    SDiskEntry *last  = entries + rowStart[i + 1];
+    SDiskEntry *found = lower_bound(first, last, j, [](const SDiskEntry &a, size_t column) { return a.column < column; });
+    return (found == last || found->column != j) ? 0 : found->value;
+}
+
+/**
+ * y = K * x streaming the rows by blocks
+ **/
+void TDiskMatrix::multiply(const vector<double> &x, vector<double> &y) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char *base = (char *)entries;
+    size_t row = 0;
+    size_t dropped = 0;
+    for (size_t block = 0; block < mappedBytes; block += blockBytes) {
+        size_t blockEnd = min(block + blockBytes, mappedBytes);
+        if (blockEnd < mappedBytes) madvise(base + blockEnd, min(blockBytes, mappedBytes - blockEnd), MADV_WILLNEED);
+        
+        // Rows whose entries end inside this block
+        size_t lastEntry = blockEnd / sizeof(SDiskEntry);
+        for (; row < size && rowStart[row + 1] <= lastEntry; row++) {
+            double sum = 0;
+            for (size_t p = rowStart[row]; p < rowStart[row + 1]; p++) sum += entries[p].value * x[entries[p].column];
+            y[row] = sum;
+        }
+        
+        // Pages that are completely behind the next row are released
+        size_t keep = rowStart[row] * sizeof(SDiskEntry) / page * page;
+        if (keep > dropped) madvise(base + dropped, keep - dropped, MADV_DONTNEED);
+        dropped = max(dropped, keep);
+    }
+    for (; row < size; row++) y[row] = 0; // empty trailing rows
+}
+
+size_t TDiskMatrix::getSize() {
+    return size;
+}
+
+size_t TDiskMatrix::getNonZeros() {
+    return rowStart.empty() ? buffer.size() : rowStart[size];
+}
+
+size_t TDiskMatrix::getAmountOfRuns() {
+    return runs.size();
+}
@@ -0,0 +1,83 @@
+//
+//  TDiskMatrix.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TDiskMatrix_hpp
+#define TDiskMatrix_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+struct STriplet {
+    size_t row;
+    size_t column;
+    double value;
+};
+
+struct SDiskEntry {
+    size_t column;
+    double value;
+};
+
+/**
+ * Symmetric matrix in compressed sparse row format stored on disk
+ * Assembly: the (row, column, value) contributions are buffered in memory
+ * and, every time the buffer reaches the memory budget, sorted and spilled
+ * to a run file. finalize() merges the runs adding the duplicates into one
+ * file of (column, value) entries by rows. Only the row starts stay in RAM.
+ *
+ * Products: the entries file is memory mapped and streamed by blocks of
+ * rows. The next block is requested in advance (read ahead) and the pages
+ * of the finished one are dropped, so the resident part of the matrix is
+ * bounded by the block size whatever the size of the matrix is.
+ **/
+class TDiskMatrix {
+    private:
+        size_t size;
+        size_t memoryBudget;
+        std::string path;
+        std::vector<STriplet> buffer;
+        std::vector<std::string> runs;
+        std::vector<size_t> rowStart;
+        int file;
+        SDiskEntry *entries;
+        size_t mappedBytes;
+        size_t blockBytes;
+    
+        void spill();
+        void merge();
+        void mapEntries();
+    
+    public:
+        TDiskMatrix(std::string path, size_t size, size_t memoryBudget);
+        virtual ~TDiskMatrix();
+    
+        void add(size_t i, size_t j, double value);
+        void finalize();
+        double get(size_t i, size_t j);
+        void multiply(const std::vector<double> &x, std::vector<double> &y);
+        size_t getSize();
+        size_t getNonZeros();
+        size_t getAmountOfRuns();
+};
+
+#endif /* TDiskMatrix_hpp */
@@ -23,20 +23,48 @@
 
 using namespace std;
 
+TElement::TElement() : B(NULL), Bt(NULL), f(NULL), conditioned(false) { }
+
+/**
+ * Elements can be released once assembled (out of core runs)
+ **/
+TElement::~TElement() {
+    gsl_matrix_free(B);
+    gsl_matrix_free(Bt);
+    gsl_vector_free(f);
+}
+
 void TElement::ini(map<size_t, SNode> ninput, std::map<size_t, SCondition> cinput, size_t minput) {
     nodes       = ninput;
-    conditions  = cinput;
     materialId  = minput;
+    setConditions(cinput);
     calculateCentroid();
     calculateArea();
     calculateB();
 }
 
-long double TElement::getArea() {
+/**
+ * New boundary values for the same nodes (a cached element reused with another F)
+ **/
+void TElement::setConditions(map<size_t, SCondition> cinput) {
+    conditions = cinput;
+    conditioned = false;
+    map<size_t, SCondition>::iterator it;
+    for (it = conditions.begin(); it != conditions.end(); it++) conditioned = conditioned || it->second.type != "unset";
+}
+
+/**
+ * Whether any node of the element has a condition
+ **/
+bool TElement::hasConditions() {
+    return conditioned;
+}
+
+TScalar TElement::getArea() {
     return area;
 }
 
-long double TElement::getEdgeLength(size_t i) {
+TScalar TElement::getEdgeLength(size_t i) {
     return diffs[i].hyp;
 }
 
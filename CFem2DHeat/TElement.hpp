@@ -31,37 +31,53 @@
 #include <gsl/gsl_matrix.h>
 #include <gsl/gsl_linalg.h>
 
-struct SCondition {
+/**
+ * Scalar type of the mesh, the conditions and the element kernels
+ * It is chosen at build time with -DCFEM_SCALAR=float|double|long double
+ * and it is double by default (the precision GSL computes with).
+ **/
+#ifndef CFEM_SCALAR
+#define CFEM_SCALAR double
+#endif
+typedef CFEM_SCALAR TScalar;
+
+template <typename T>
+struct SConditionOf {
     std::string type;
-    long double temperature;
-    long double flux;
-    long double ambient;
+    T temperature;
+    T flux;
+    T ambient;
 };
 
-struct SNode {
-    long double x;
-    long double y;
+template <typename T>
+struct SNodeOf {
+    T x;
+    T y;
 };
 
-struct SDiff {
-    long double x;
-    long double y;
-    long double hyp;
+template <typename T>
+struct SDiffOf {
+    T x;
+    T y;
+    T hyp;
 };
 
+typedef SConditionOf<TScalar> SCondition;
+typedef SNodeOf<TScalar> SNode;
+typedef SDiffOf<TScalar> SDiff;
+
 class TElement {
     protected:
         size_t materialId;
-        long double area;
+        TScalar area;
         gsl_matrix * B;
         gsl_matrix * Bt;
         gsl_vector * f;
-        gsl_vector * fc;
-        gsl_vector * ff;
     
         SNode center;
     
         std::map<size_t, SCondition> conditions;
+        bool conditioned;
     
         std::vector<SDiff> diffs;
         std::vector<SDiff> centerDiffs;
@@ -72,10 +88,12 @@ class TElement {
     
     public:
         std::map<size_t, SNode> nodes;
+        TElement();
+        virtual ~TElement();
         void ini(std::map<size_t, SNode> ninput, std::map<size_t, SCondition> cinput, size_t minput);
-        long double getArea();
-        long double getPerimeter();
-        long double getEdgeLength(size_t i);
+        TScalar getArea();
+        TScalar getPerimeter();
+        TScalar getEdgeLength(size_t i);
         SNode getCenter();
         SDiff getDiff(size_t i);
         SDiff getCenterDiff(size_t i);
@@ -83,13 +101,11 @@ class TElement {
         gsl_matrix * getBt();
         std::vector<size_t> getNodeIds();
         size_t getMaterialId();
+        void setConditions(std::map<size_t, SCondition> cinput);
+        bool hasConditions();
     
-        virtual size_t getEdgeIndex(size_t i, size_t j) = 0;
-        virtual gsl_matrix * getKd(long double conductivity) = 0;
-        virtual gsl_matrix * getKm(long double convectivity) = 0;
+        virtual gsl_matrix * getKd(TScalar conductivity) = 0;
         virtual gsl_vector * getF() = 0;
-        virtual gsl_vector * getFConvection(long double convectivity) = 0;
-        virtual gsl_vector * getFFlux(long double convectivity) = 0;
 };
 
 #endif /* TElement_hpp */
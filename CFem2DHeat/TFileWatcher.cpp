@@ -0,0 +1,100 @@
+//
+//  TFileWatcher.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TFileWatcher.hpp"
+
+#include <thread>
+#include <chrono>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+using namespace std;
+
+const unsigned int TFileWatcher::POLL_MS;
+const unsigned int TFileWatcher::SETTLE_MS;
+
+TFileWatcher::TFileWatcher(string path) : path(path), descriptor(-1) {
+    size_t slash = path.rfind('/');
+    directory   = (slash == string::npos) ? "." : path.substr(0, slash + 1);
+    name        = (slash == string::npos) ? path : path.substr(slash + 1);
+    modified    = getModified();
+#ifdef __linux__
+    descriptor = inotify_init();
+    if (descriptor >= 0 && inotify_add_watch(descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        close(descriptor);
+        descriptor = -1;
+    }
+#endif
+}
+
+TFileWatcher::~TFileWatcher() {
+    if (descriptor >= 0) close(descriptor);
+}
+
+time_t TFileWatcher::getModified() {
+    struct stat info;
+    return (stat(path.c_str(), &info) == 0) ? info.st_mtime : 0;
+}
+
+/**
+ * Blocks until the file changes, false if it cannot be watched
+ **/
+bool TFileWatcher::wait() {
+#ifdef __linux__
+    if (descriptor >= 0) {
+        char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+        bool changed = false;
+        while (!changed) {
+            ssize_t amount = read(descriptor, buffer, sizeof(buffer));
+            if (amount <= 0) return false;
+            for (char *p = buffer; p < buffer + amount; p += sizeof(struct inotify_event) + ((struct inotify_event *)p)->len) {
+                struct inotify_event *event = (struct inotify_event *)p;
+                if (event->len > 0 && name == event->name) changed = true;
+            }
+        }
+        
+        // Letting the rest of the burst go
+        pollfd pending = {descriptor, POLLIN, 0};
+        while (poll(&pending, 1, SETTLE_MS) > 0) {
+            if (read(descriptor, buffer, sizeof(buffer)) <= 0) break;
+        }
+        modified = getModified();
+        return true;
+    }
+#endif
+    while (true) {
+        this_thread::sleep_for(chrono::milliseconds(POLL_MS));
+        time_t current = getModified();
+        if (current == modified) continue;
+        
+        // Waiting until it stops changing
+        do {
+            modified = current;
+            this_thread::sleep_for(chrono::milliseconds(SETTLE_MS));
+            current = getModified();
+        } while (current != modified);
+        return true;
+    }
+}
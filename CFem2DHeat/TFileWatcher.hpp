@@ -0,0 +1,55 @@
+//
+//  TFileWatcher.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TFileWatcher_hpp
+#define TFileWatcher_hpp
+
+#include <stdio.h>
+#include <string>
+
+/**
+ * Waits until a file is written again
+ * On Linux the directory of the file is watched with inotify, so files that
+ * are replaced (written to a temporary and renamed) are seen too. Elsewhere
+ * the modification time of the file is polled.
+ * A burst of writes (GiD writes the file by parts) is reported once.
+ **/
+class TFileWatcher {
+    private:
+        std::string path;
+        std::string directory;
+        std::string name;
+        int descriptor;
+        time_t modified;
+    
+        time_t getModified();
+    
+    public:
+        static const unsigned int POLL_MS = 250;    // polling period without inotify
+        static const unsigned int SETTLE_MS = 100;  // quiet time closing a burst of writes
+    
+        TFileWatcher(std::string path);
+        virtual ~TFileWatcher();
+    
+        bool wait();
+};
+
+#endif /* TFileWatcher_hpp */
@@ -0,0 +1,129 @@
+//
+//  TInitialGuess.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TInitialGuess.hpp"
+#include "TInputParser.hpp"
+#include "TSpatialGrid.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Both files are read here, before the current input file uses the parser
+ **/
+TInitialGuess::TInitialGuess(string fileName) : fileName(fileName), mapping("id"), outside(0) {
+    readResults();
+    const string suffix = ".post.res";
+    if (fileName.size() > suffix.size() && fileName.compare(fileName.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        readMesh(fileName.substr(0, fileName.size() - suffix.size()) + ".dat");
+    }
+}
+
+TInitialGuess::~TInitialGuess() { }
+
+void TInitialGuess::readResults() {
+    ifstream inFile(fileName.c_str());
+    if (!inFile.is_open()) throw runtime_error("ERROR: Cannot open the initial guess file " + fileName + ".");
+    string line;
+    bool found = false;
+    while (!found && getline(inFile, line)) found = line.compare(0, 20, "Result \"Temperature\"") == 0;
+    while (found && getline(inFile, line) && line != "Values");
+    while (found && getline(inFile, line) && line != "End values") {
+        vector<string> tmp = TSString::split(line, " ");
+        if (tmp.size() >= 2) temperatures[atoi(tmp[0].c_str())] = atof(tmp[1].c_str());
+    }
+    if (temperatures.empty()) throw runtime_error("ERROR: No Temperature result in the initial guess file " + fileName + ".");
+}
+
+void TInitialGuess::readMesh(string meshName) {
+    ifstream probe(meshName.c_str());
+    if (!probe.is_open()) return; // mapped by id
+    probe.close();
+    
+    TInputParser::reset();
+    TInputParser::setElementHook(nullptr);
+    TInputParser::setKeepElements(true);
+    TInputParser::readFile(meshName);
+    coordinates = TInputParser::getCoordinates();
+    map<size_t, TElement*> connectivities = TInputParser::getConnectivities();
+    map<size_t, TElement*>::iterator it;
+    for (it = connectivities.begin(); it != connectivities.end(); it++) {
+        triangles.push_back(it->second->getNodeIds());
+        delete it->second;
+    }
+    TInputParser::reset();
+}
+
+bool TInitialGuess::isSameMesh(map<size_t, SNode> &current) {
+    if (coordinates.empty()) return true;
+    if (coordinates.size() != current.size()) return false;
+    map<size_t, SNode>::iterator it;
+    for (it = current.begin(); it != current.end(); it++) {
+        map<size_t, SNode>::iterator previous = coordinates.find(it->first);
+        if (previous == coordinates.end()) return false;
+        if (fabs(previous->second.x - it->second.x) > 1e-9 * (1 + fabs(it->second.x))) return false;
+        if (fabs(previous->second.y - it->second.y) > 1e-9 * (1 + fabs(it->second.y))) return false;
+    }
+    return true;
+}
+
+/**
+ * Setting A (node id - 1) from the previous temperatures
+ **/
+void TInitialGuess::apply(map<size_t, SNode> &current, gsl_vector *A) {
+    if (isSameMesh(current)) {
+        map<size_t, TScalar>::iterator it;
+        for (it = temperatures.begin(); it != temperatures.end(); it++) {
+            if (it->first >= 1 && it->first <= A->size) gsl_vector_set(A, it->first - 1, it->second);
+        }
+        return;
+    }
+    
+    mapping = "spatial lookup";
+    TSpatialGrid grid(coordinates, triangles);
+    map<size_t, SNode>::iterator it;
+    for (it = current.begin(); it != current.end(); it++) {
+        if (it->first < 1 || it->first > A->size) continue;
+        size_t triangle;
+        TScalar weights[3];
+        TScalar value = 0;
+        if (grid.locate(it->second, triangle, weights)) {
+            vector<size_t> &nodeIds = grid.getTriangle(triangle);
+            for (size_t j = 0; j < 3; j++) value += weights[j] * temperatures[nodeIds[j]];
+        } else {
+            value = temperatures[grid.nearest(it->second)];
+            outside++;
+        }
+        gsl_vector_set(A, it->first - 1, value);
+    }
+}
+
+string TInitialGuess::getMapping() {
+    return mapping;
+}
+
+size_t TInitialGuess::getOutside() {
+    return outside;
+}
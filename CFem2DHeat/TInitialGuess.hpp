@@ -0,0 +1,64 @@
+//
+//  TInitialGuess.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TInitialGuess_hpp
+#define TInitialGuess_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <gsl/gsl_vector.h>
+
+#include "TElement.hpp"
+
+/**
+ * Temperatures of a previous run as the initial guess of the iterative solvers
+ * The Temperature block of a GiD .post.res is read and mapped onto the
+ * current nodes by id. If the input file of that run is next to it
+ * (name.post.res -> name.dat) and its mesh is not the current one, the
+ * temperatures are interpolated at the current nodes from the previous
+ * triangles instead (the nearest previous node for the nodes outside them).
+ **/
+class TInitialGuess {
+    private:
+        std::string fileName;
+        std::map<size_t, TScalar> temperatures;     // by node id of the previous run
+        std::map<size_t, SNode> coordinates;        // previous mesh, empty without its input file
+        std::vector<std::vector<size_t> > triangles;
+        std::string mapping;
+        size_t outside;
+    
+        void readResults();
+        void readMesh(std::string meshName);
+        bool isSameMesh(std::map<size_t, SNode> &current);
+    
+    public:
+        TInitialGuess(std::string fileName);
+        virtual ~TInitialGuess();
+    
+        void apply(std::map<size_t, SNode> &current, gsl_vector *A);
+        std::string getMapping();
+        size_t getOutside();
+};
+
+#endif /* TInitialGuess_hpp */
@@ -21,6 +21,11 @@
 
 #include "TInputParser.hpp"
 
+#include <ctype.h>
+#include <math.h>
+
+#include "TSLog.hpp"
+
 using namespace std;
 
 ifstream TInputParser::inFile;
@@ -36,7 +41,15 @@ map<size_t, SMaterial> TInputParser::Materials;
 map<size_t, SCondition> TInputParser::Conditions;
 map<size_t, SNode> TInputParser::Coordinates;
 map<size_t, TElement*> TInputParser::Connectivities;
+map<size_t, size_t> TInputParser::Substructures;
+map<pair<size_t, size_t>, SEdgeCandidate> TInputParser::Edges;
+vector<SConditionGroup> TInputParser::Groups;
 map<string, unsigned int> TInputParser::fileSections;
+function<void(size_t, TElement*)> TInputParser::elementHook;
+bool TInputParser::keepElements = true;
+bool TInputParser::readGeometry = true;
+size_t TInputParser::modelHash;
+map<unsigned int, size_t> TInputParser::sectionHashes;
 
 TInputParser::TInputParser() { }
 
@@ -47,6 +60,8 @@ void TInputParser::readFile(string fileName) {
     inFile.open(fileName.c_str());
     currentFileSection = TInputParser::FILE_BEGINNING;
     status = TInputParser::FAIL;
+    modelHash = 14695981039346656037ULL;
+    sectionHashes.clear();
     if (inFile.is_open()) {
         fileSections["Geometry Unit:"]              = TInputParser::FILE_UNIT;
         fileSections["Number of Elements & Nodes:"] = TInputParser::FILE_AMOUNTS;
@@ -55,6 +70,7 @@ void TInputParser::readFile(string fileName) {
         fileSections["Coordinates:"]                = TInputParser::FILE_COORDINATES;
         fileSections["Connectivities:"]             = TInputParser::FILE_CONNECTIVITIES;
         fileSections["Begin Materials"]             = TInputParser::FILE_MATERIALS;
+        fileSections["Substructures:"]              = TInputParser::FILE_SUBSTRUCTURES;
         while (!inFile.eof()) {
             getline(inFile, line);
             updateCurrentFileSection(line);
@@ -65,6 +81,7 @@ void TInputParser::readFile(string fileName) {
                 case TInputParser::FILE_CONDITIONS:      parseCondition(); break;
                 case TInputParser::FILE_COORDINATES:     parseNode();      break;
                 case TInputParser::FILE_CONNECTIVITIES:  parseElement();   break;
+                case TInputParser::FILE_SUBSTRUCTURES:   parseSubstructure(); break;
                 default: break;
             }
         }
@@ -75,6 +92,84 @@ void TInputParser::readFile(string fileName) {
     currentFileSection = TInputParser::FILE_END;
 }
 
+/**
+ * Called with every element as soon as it is read, so it can be processed
+ * while the rest of the file is parsed. The materials, conditions and
+ * coordinates come before the connectivities so they are complete by then.
+ **/
+void TInputParser::setElementHook(function<void(size_t, TElement*)> hook) {
+    elementHook = hook;
+}
+
+/**
+ * Without keeping them the elements are only given to the element hook,
+ * which owns them from then on (out of core runs release them once assembled)
+ **/
+void TInputParser::setKeepElements(bool keep) {
+    keepElements = keep;
+}
+
+/**
+ * Without the geometry the coordinates and connectivities are only hashed,
+ * a quick read of the conditions for the cached models (server mode)
+ **/
+void TInputParser::setReadGeometry(bool read) {
+    readGeometry = read;
+}
+
+/**
+ * Forgetting the previous file so another one (or the same one again) can be read
+ * The elements are not released, they belong to whoever got them
+ **/
+void TInputParser::reset() {
+    Materials.clear();
+    Conditions.clear();
+    Coordinates.clear();
+    Connectivities.clear();
+    Substructures.clear();
+    Edges.clear();
+    Groups.clear();
+    amountOfConditions = amountOfNodes = amountOfElements = amountOfMaterials = 0;
+}
+
+/**
+ * The line is normalized first, runs of white space count as a single space
+ * and the leading and trailing ones are ignored
+ **/
+void TInputParser::hash(size_t &value, string line) {
+    bool space = false, started = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        unsigned char c = line[i];
+        if (isspace(c)) {
+            space = true;
+            continue;
+        }
+        if (space && started) {
+            value ^= ' ';
+            value *= 1099511628211ULL;
+        }
+        space = false;
+        started = true;
+        value ^= c;
+        value *= 1099511628211ULL;
+    }
+    value ^= '\n';
+    value *= 1099511628211ULL;
+}
+
+/**
+ * FNV-1a hashes of the file
+ * The model hash has everything K depends on: unit, amounts, materials, coordinates,
+ * connectivities, substructures and the condition type of each node.
+ * The condition values only change F so they are left out of it (model = false),
+ * every line is in the hash of its section so two reads can be compared by section.
+ **/
+void TInputParser::hashLine(string line, bool model) {
+    if (sectionHashes.find(currentFileSection) == sectionHashes.end()) sectionHashes[currentFileSection] = 14695981039346656037ULL;
+    hash(sectionHashes[currentFileSection], line);
+    if (model) hash(modelHash, line);
+}
+
 void TInputParser::updateCurrentFileSection(string line) {
     currentFileSection = (fileSections.find(line) != fileSections.end())
         ? fileSections.at(line)
@@ -83,6 +178,7 @@ void TInputParser::updateCurrentFileSection(string line) {
 
 void TInputParser::parseUnit() {
     getline(inFile, unit);
+    hashLine(unit);
     factor = 1;
     if (unit == "DM") factor = 10;
     if (unit == "CM") factor = 100;
@@ -93,6 +189,7 @@ void TInputParser::parseUnit() {
 void TInputParser::parseAmounts() {
     string line;
     getline(inFile, line);
+    hashLine(line);
     vector<string> tmp  = TSString::split(line, " ");
     amountOfElements    = atoi(tmp[0].c_str());
     amountOfNodes       = atoi(tmp[1].c_str());
@@ -107,6 +204,7 @@ void TInputParser::parseMaterial() {
     getline(inFile, line);
     for (size_t i = 0; i < amountOfMaterials; i++) {
         getline(inFile, line);
+        hashLine(line);
         vector<string> tmp = TSString::split(line, " ");
         SMaterial OMaterial;
         OMaterial.conductivity = atof(tmp[1].c_str()) / factor;
@@ -123,6 +221,11 @@ void TInputParser::parseCondition() {
     size_t amount = atoi(line.c_str());
     getline(inFile, type);
     getline(inFile, line);
+    SConditionGroup OGroup;
+    OGroup.type     = type;
+    OGroup.value    = 0;
+    OGroup.uniform  = true;
+    Groups.push_back(OGroup);
     for (size_t i = 0; i < amount; i++) {
         getline(inFile, line);
         vector<string> tmp = TSString::split(line, " ");
@@ -140,7 +243,20 @@ void TInputParser::parseCondition() {
         }
 
         size_t nodeId = atoi(tmp[0].c_str());
-        if (Conditions.find(nodeId) != Conditions.end() && Conditions[nodeId].type == OCondition.type) {
+        hashLine(line, false);
+        hashLine(tmp[0] + " " + type);
+        TScalar value = OCondition.temperature + OCondition.flux + OCondition.ambient;
+        if (i == 0) Groups.back().value = value;
+        else if (value != Groups.back().value) Groups.back().uniform = false;
+        bool averaged = Conditions.find(nodeId) != Conditions.end() && Conditions[nodeId].type == OCondition.type;
+        for (size_t g = 0; g < Groups.size(); g++) {
+            map<size_t, TScalar>::iterator weight = Groups[g].weights.find(nodeId);
+            if (weight == Groups[g].weights.end()) continue;
+            if (averaged) weight->second /= 2;
+            else Groups[g].weights.erase(weight);
+        }
+        Groups.back().weights[nodeId] += averaged ? 0.5 : 1;
+        if (averaged) {
             OCondition.temperature  = (Conditions[nodeId].temperature + OCondition.temperature) / 2;
             OCondition.flux         = (Conditions[nodeId].flux + OCondition.flux) / 2;
             OCondition.ambient      = (Conditions[nodeId].ambient + OCondition.ambient) / 2;
@@ -155,6 +271,8 @@ void TInputParser::parseNode() {
     getline(inFile, line);
     for (size_t i = 0; i < amountOfNodes; i++) {
         getline(inFile, line);
+        hashLine(line);
+        if (!readGeometry) continue;
         vector<string> tmp = TSString::split(line, " ");
         SNode ONode;
         ONode.x = atof(tmp[1].c_str());
@@ -170,6 +288,8 @@ void TInputParser::parseElement() {
     SCondition OCondition; OCondition.type = "unset";
     for (size_t i = 0; i < amountOfElements; i++) {
         getline(inFile, line);
+        hashLine(line);
+        if (!readGeometry) continue;
         vector<string> tmp = TSString::split(line, " ");
         if (tmp.size() > 5) throw runtime_error("Error: Sorry, It supports triangle elements only for now. Sorry :)");
         TTriangle *OElement = new TTriangle();
@@ -181,7 +301,46 @@ void TInputParser::parseElement() {
             elmConditions[nodeId]   = (Conditions.find(nodeId) != Conditions.end()) ? Conditions[nodeId] : OCondition;
         }
         OElement->ini(elmNodes, elmConditions, atoi(tmp[4].c_str()));
-        Connectivities[atoi(tmp[0].c_str())] = OElement;
+        
+        // Candidate boundary edges, the Line conditions are given by node
+        for (unsigned int j = 1; j < 4; j++) {
+            size_t first = atoi(tmp[j].c_str()), second = atoi(tmp[j % 3 + 1].c_str());
+            string type = elmConditions[first].type;
+            if ((type != "Convection" && type != "Flux") || elmConditions[second].type != type) continue;
+            pair<size_t, size_t> key(min(first, second), max(first, second));
+            if (Edges.find(key) != Edges.end()) {
+                Edges[key].elements++;
+                continue;
+            }
+            SEdgeCandidate OEdge;
+            OEdge.type          = (type == "Convection") ? TBoundary::CONVECTION : TBoundary::FLUX;
+            OEdge.elements      = 1;
+            OEdge.length        = hypot(Coordinates[second].x - Coordinates[first].x, Coordinates[second].y - Coordinates[first].y);
+            OEdge.coefficient   = (OEdge.type == TBoundary::CONVECTION) ? Materials[OElement->getMaterialId()].convectivity : 1;
+            OEdge.material      = OElement->getMaterialId();
+            Edges[key] = OEdge;
+        }
+        if (keepElements) Connectivities[atoi(tmp[0].c_str())] = OElement;
+        if (elementHook) elementHook(atoi(tmp[0].c_str()), OElement);
+        else if (!keepElements) delete OElement;
+    }
+    currentFileSection = TInputParser::FILE_NO_RELEVANT;
+}
+
+/**
+ * Elements tagged as part of a repeated substructure (element id -> substructure id)
+ * Files written before this section existed just leave it empty
+ **/
+void TInputParser::parseSubstructure() {
+    string line;
+    getline(inFile, line);
+    size_t amount = atoi(line.c_str());
+    getline(inFile, line);
+    for (size_t i = 0; i < amount; i++) {
+        getline(inFile, line);
+        hashLine(line);
+        vector<string> tmp = TSString::split(line, " ");
+        Substructures[atoi(tmp[0].c_str())] = atoi(tmp[1].c_str());
     }
     currentFileSection = TInputParser::FILE_NO_RELEVANT;
 }
@@ -222,33 +381,76 @@ map<size_t, TElement*> TInputParser::getConnectivities() {
     return Connectivities;
 }
 
+vector<SConditionGroup> TInputParser::getGroups() {
+    return Groups;
+}
+
+map<size_t, size_t> TInputParser::getSubstructures() {
+    return Substructures;
+}
+
+/**
+ * The loaded edges of a single element, with the values of the conditions read
+ **/
+TBoundary * TInputParser::getBoundary() {
+    TBoundary *OBoundary = new TBoundary();
+    map<pair<size_t, size_t>, SEdgeCandidate>::iterator it;
+    for (it = Edges.begin(); it != Edges.end(); it++) {
+        if (it->second.elements != 1) continue;
+        OBoundary->addEdge(it->second.type, it->first.first, it->first.second, it->second.length, it->second.coefficient, it->second.material);
+    }
+    OBoundary->setValues(Conditions);
+    return OBoundary;
+}
+
 size_t TInputParser::getFactor() {
     return factor;
 }
 
+size_t TInputParser::getModelHash() {
+    return modelHash;
+}
+
+map<unsigned int, size_t> TInputParser::getSectionHashes() {
+    return sectionHashes;
+}
+
+string TInputParser::getSectionName(unsigned int section) {
+    switch (section) {
+        case TInputParser::FILE_UNIT:           return "Unit";
+        case TInputParser::FILE_AMOUNTS:        return "Amounts";
+        case TInputParser::FILE_MATERIALS:      return "Materials";
+        case TInputParser::FILE_CONDITIONS:     return "Conditions";
+        case TInputParser::FILE_COORDINATES:    return "Coordinates";
+        case TInputParser::FILE_CONNECTIVITIES: return "Connectivities";
+        case TInputParser::FILE_SUBSTRUCTURES:  return "Substructures";
+        default: return "Unknown";
+    }
+}
+
 void TInputParser::printMaterials() {
     map<size_t, SMaterial>::iterator it;
     for (it = Materials.begin(); it != Materials.end(); it++) {
-        cout << "Material: Id " << it->first;
-        cout << " Conductivity " << it->second.conductivity;
-        cout << " Convectivity " << it->second.convectivity << endl;
+        TLogLine(TSLog::TRACE, TSLog::PARSE) << "Material: Id " << it->first << " Conductivity " << it->second.conductivity
+                                             << " Convectivity " << it->second.convectivity << endl;
     }
 }
 
 void TInputParser::printConditions() {
     map<size_t, SCondition>::iterator it;
     for (it = Conditions.begin(); it != Conditions.end(); it++) {
-        cout << "Condition: Node " << it->first;
-        if (it->second.type == "Temperature") cout << " Temperature " << it->second.temperature << endl;
-        if (it->second.type == "Flux") cout << " Flux " << it->second.flux << endl;
-        if (it->second.type == "Convection") cout << " Convection Ambient Temperature " << it->second.ambient << endl;
+        TLogLine line(TSLog::TRACE, TSLog::PARSE);
+        line << "Condition: Node " << it->first;
+        if (it->second.type == "Temperature") line << " Temperature " << it->second.temperature << endl;
+        if (it->second.type == "Flux") line << " Flux " << it->second.flux << endl;
+        if (it->second.type == "Convection") line << " Convection Ambient Temperature " << it->second.ambient << endl;
     }
 }
 
 void TInputParser::printCoordinates() {
     map<size_t, SNode>::iterator it;
     for (it = Coordinates.begin(); it != Coordinates.end(); it++) {
-        cout << "Node: Id " << it->first << " Coords(" << it->second.x << ", " << it->second.y << ")" << endl;
+        TLogLine(TSLog::TRACE, TSLog::PARSE) << "Node: Id " << it->first << " Coords(" << it->second.x << ", " << it->second.y << ")" << endl;
     }
 }
 
@@ -256,9 +458,11 @@ void TInputParser::printConnectivities() {
     map<size_t, TElement*>::iterator it;
     map<size_t, SNode>::iterator itn;
     for (it = Connectivities.begin(); it != Connectivities.end(); it++) {
-        cout << "Element: Id " << it->first << " Nodes [ ";
-        for (itn = it->second->nodes.begin(); itn != it->second->nodes.end(); itn++) cout << itn->first << " ";
-        cout << "] Material " << it->second->getMaterialId() << endl;
+        TLogLine line(TSLog::TRACE, TSLog::PARSE);
+        if (!line.isActive()) continue;
+        line << "Element: Id " << it->first << " Nodes [ ";
+        for (itn = it->second->nodes.begin(); itn != it->second->nodes.end(); itn++) line << itn->first << " ";
+        line << "] Material " << it->second->getMaterialId() << endl;
     }
 }
 
@@ -28,13 +28,42 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <functional>
 
 #include "TSString.hpp"
 #include "TTriangle.hpp"
+#include "TBoundary.hpp"
 
-struct SMaterial {
-    long double conductivity;
-    long double convectivity;
+template <typename T>
+struct SMaterialOf {
+    T conductivity;
+    T convectivity;
+};
+
+typedef SMaterialOf<TScalar> SMaterial;
+
+/**
+ * Element edge with both nodes loaded by the same Line condition,
+ * it is on the boundary when a single element has it
+ **/
+struct SEdgeCandidate {
+    unsigned int type;      // TBoundary::CONVECTION or TBoundary::FLUX
+    size_t elements;
+    TScalar length;
+    TScalar coefficient;
+    size_t material;
+};
+
+/**
+ * Block of conditions of the input file (Point or Line conditions)
+ * A node in two blocks of the same type gets the mean of their values, so
+ * its value is the sum of the block values by their weights
+ **/
+struct SConditionGroup {
+    std::string type;
+    TScalar value;                      // of its first node, as in SCondition
+    bool uniform;                       // the same value for every node
+    std::map<size_t, TScalar> weights;  // by node id
 };
 
 class TInputParser {
@@ -52,8 +81,18 @@ class TInputParser {
         static std::map<size_t, SNode> Coordinates;
         static std::map<size_t, TElement*> Connectivities;
         static std::map<size_t, SMaterial> Materials;
+        static std::map<size_t, size_t> Substructures;
+        static std::map<std::pair<size_t, size_t>, SEdgeCandidate> Edges;
+        static std::vector<SConditionGroup> Groups;
         static std::map<std::string, unsigned int> fileSections;
+        static std::function<void(size_t, TElement*)> elementHook;
+        static bool keepElements;
+        static bool readGeometry;
+        static size_t modelHash;
+        static std::map<unsigned int, size_t> sectionHashes;
     
+        static void hash(size_t &value, std::string line);
+        static void hashLine(std::string line, bool model = true);
         static void updateCurrentFileSection(std::string line);
         static void parseUnit();
         static void parseAmounts();
@@ -61,6 +100,7 @@ class TInputParser {
         static void parseCondition();
         static void parseNode();
         static void parseElement();
+        static void parseSubstructure();
     
     public:
         static const unsigned int FAIL = 0;
@@ -75,11 +115,16 @@ class TInputParser {
         static const unsigned int FILE_CONDITIONS = 60;
         static const unsigned int FILE_END = 70;
         static const unsigned int FILE_NO_RELEVANT = 80;
+        static const unsigned int FILE_SUBSTRUCTURES = 90;
     
         TInputParser();
         virtual ~TInputParser();
     
         static void readFile(std::string fileName);
+        static void setElementHook(std::function<void(size_t, TElement*)> hook);
+        static void setKeepElements(bool keep);
+        static void setReadGeometry(bool read);
+        static void reset();
         static size_t getStatus();
         static size_t getUnit();
         static size_t getAmountOfMaterials();
@@ -87,10 +132,16 @@ class TInputParser {
         static size_t getAmountOfNodes();
         static size_t getAmountOfElements();
         static size_t getFactor();
+        static size_t getModelHash();
+        static std::map<unsigned int, size_t> getSectionHashes();
+        static std::string getSectionName(unsigned int section);
         static std::map<size_t, SMaterial> getMaterials();
         static std::map<size_t, SCondition> getConditions();
+        static std::vector<SConditionGroup> getGroups();
         static std::map<size_t, SNode> getCoordinates();
         static std::map<size_t, TElement*> getConnectivities();
+        static std::map<size_t, size_t> getSubstructures();
+        static TBoundary * getBoundary();
     
         static void printConditions();
         static void printCoordinates();
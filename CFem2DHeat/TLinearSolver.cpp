@@ -0,0 +1,175 @@
+//
+//  TLinearSolver.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TLinearSolver.hpp"
+
+#include <unistd.h>
+#include <algorithm>
+
+#include "TSOrdering.hpp"
+#include "TDenseSolver.hpp"
+#include "TSkylineSolver.hpp"
+#include "TCholeskySolver.hpp"
+#include "TPCGSolver.hpp"
+#include "TMixedSolver.hpp"
+#include "TSchwarzSolver.hpp"
+
+using namespace std;
+
+size_t TLinearSolver::memoryLimit = 0;
+
+static TLinearSolver * createDense()     { return new TDenseSolver(); }
+static TLinearSolver * createSkyline()   { return new TSkylineSolver(); }
+static TLinearSolver * createCholesky()  { return new TCholeskySolver<double>(); }
+static TLinearSolver * createMixed()     { return new TMixedSolver(new TCholeskySolver<float>()); }
+static TLinearSolver * createPCGJacobi() { return new TPCGSolver(TPCGSolver::JACOBI); }
+static TLinearSolver * createPCGIC0()    { return new TPCGSolver(TPCGSolver::IC0); }
+static TLinearSolver * createSchwarz()   { return new TSchwarzSolver(); }
+
+TLinearSolver::TLinearSolver() : size(0), iterations(0), residual(0), converged(true), checkpoint(NULL) {
+    options.tolerance       = 1e-10;
+    options.maxIterations   = 0; // 0 means as many as unknowns
+}
+
+TLinearSolver::~TLinearSolver() { }
+
+/**
+ * Solvers only need K by default
+ **/
+void TLinearSolver::setMesh(map<size_t, TElement*> &) { }
+
+/**
+ * Default multiple right hand side solve
+ * The factorization (or preconditioner) is shared by every solve
+ **/
+void TLinearSolver::solveMany(vector<gsl_vector *> &b, vector<gsl_vector *> &x) {
+    for (size_t i = 0; i < b.size(); i++) solve(b[i], x[i]);
+}
+
+/**
+ * Amount of values stored by the factorization or preconditioner
+ **/
+size_t TLinearSolver::getFactorSize() {
+    return 0;
+}
+
+void TLinearSolver::setOptions(SSolverOptions options) {
+    this->options = options;
+}
+
+/**
+ * NULL to stop checkpointing, the checkpoint is not owned by the solver
+ **/
+void TLinearSolver::setCheckpoint(TCheckpoint *checkpoint) {
+    this->checkpoint = checkpoint;
+}
+
+size_t TLinearSolver::getIterations() {
+    return iterations;
+}
+
+double TLinearSolver::getResidual() {
+    return residual;
+}
+
+bool TLinearSolver::hasConverged() {
+    return converged;
+}
+
+map<string, TLinearSolver * (*)()> & TLinearSolver::getRegistry() {
+    static map<string, TLinearSolver * (*)()> registry = {
+        {"dense",       createDense},
+        {"skyline",     createSkyline},
+        {"cholesky",    createCholesky},
+        {"mixed",       createMixed},
+        {"pcg-jacobi",  createPCGJacobi},
+        {"pcg-ic0",     createPCGIC0},
+        {"schwarz",     createSchwarz}
+    };
+    return registry;
+}
+
+void TLinearSolver::registerSolver(string name, TLinearSolver * (*factory)()) {
+    getRegistry()[name] = factory;
+}
+
+vector<string> TLinearSolver::getNames() {
+    vector<string> names;
+    map<string, TLinearSolver * (*)()>::iterator it;
+    for (it = getRegistry().begin(); it != getRegistry().end(); it++) names.push_back(it->first);
+    return names;
+}
+
+/**
+ * It returns NULL when there is no backend with that name
+ **/
+TLinearSolver * TLinearSolver::create(string name) {
+    if (getRegistry().find(name) == getRegistry().end()) return NULL;
+    return getRegistry()[name]();
+}
+
+/**
+ * Automatic backend selection
+ * 1. Dense packed Cholesky for small problems if N^2 / 2 values fit in memory.
+ * 2. Skyline Cholesky when the Reverse Cuthill-McKee profile fits in memory
+ *    and its factorization is cheap enough (sum of squared column heights).
+ * 3. Sparse Cholesky with nested dissection when its factor fits in memory.
+ * 4. Otherwise conjugate gradient with incomplete Cholesky, which only
+ *    needs memory for K, its preconditioner and a few vectors.
+ * Only half of the available memory is given to the factorization, and
+ * not more than the limit of the memory planner (if any).
+ **/
+string TLinearSolver::selectAuto(TSparseMatrix *K) {
+    size_t amountOfNodes = K->getSize();
+    double memory = (double)getAvailableMemory() / 2;
+    if (memoryLimit > 0) memory = min(memory, (double)memoryLimit);
+    
+    if (amountOfNodes <= DENSE_LIMIT && (double)amountOfNodes * (amountOfNodes + 1) / 2 * sizeof(double) < memory)
+        return "dense";
+    
+    double flops = 0;
+    vector<vector<size_t> > adjacency = K->getAdjacency();
+    size_t profile = TSOrdering::getProfile(adjacency, TSOrdering::reverseCuthillMcKee(adjacency), flops);
+    if (flops <= SKYLINE_FLOPS_LIMIT && (double)profile * sizeof(double) < memory)
+        return "skyline";
+    
+    TCholeskySolver<double> probe;
+    probe.analyze(K);
+    if ((double)probe.getFactorSize() * (sizeof(double) + sizeof(size_t)) < memory)
+        return "cholesky";
+    
+    return "pcg-ic0";
+}
+
+/**
+ * Bytes the automatic selection can give to the factorization, 0 for no limit
+ **/
+void TLinearSolver::setMemoryLimit(size_t memoryLimit) {
+    TLinearSolver::memoryLimit = memoryLimit;
+}
+
+size_t TLinearSolver::getAvailableMemory() {
+#ifdef _SC_AVPHYS_PAGES
+    return (size_t)sysconf(_SC_AVPHYS_PAGES) * (size_t)sysconf(_SC_PAGESIZE);
+#else
+    return (size_t)sysconf(_SC_PHYS_PAGES) * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
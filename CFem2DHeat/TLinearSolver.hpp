@@ -0,0 +1,99 @@
+//
+//  TLinearSolver.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TLinearSolver_hpp
+#define TLinearSolver_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <gsl/gsl_vector.h>
+
+#include "TSparseMatrix.hpp"
+#include "TCheckpoint.hpp"
+
+struct SSolverOptions {
+    double tolerance;
+    size_t maxIterations;
+    size_t subdomains;          // schwarz, 0 for one per thread
+    size_t overlap;             // schwarz, layers of nodes added to each subdomain
+};
+
+/**
+ * Common lifecycle of the K/F = A solvers
+ * setMesh:    optional, geometric information for the solvers that use it
+ * analyze:    symbolic work that only depends on the pattern (ordering, envelope, fill)
+ * factorize:  numeric factorization or preconditioner setup for the values of K
+ * solve:      one right hand side, x is also the initial guess of iterative solvers
+ * solveMany:  several right hand sides with the same factorization
+ *
+ * The iterative solvers save their state in the checkpoint given to
+ * setCheckpoint (if any) and resume from it, see TCheckpoint.
+ *
+ * Backends are registered by name so they can be chosen with --solver=<name>.
+ * The "auto" name picks one from the problem size, the estimated fill and
+ * the available memory.
+ **/
+class TLinearSolver {
+    protected:
+        size_t size;
+        size_t iterations;
+        double residual;
+        bool converged;
+        SSolverOptions options;
+        TCheckpoint *checkpoint;
+    
+        static size_t memoryLimit;
+    
+        static std::map<std::string, TLinearSolver * (*)()> & getRegistry();
+    
+    public:
+        static const size_t DENSE_LIMIT = 500;
+        static constexpr double SKYLINE_FLOPS_LIMIT = 2e9;
+    
+        TLinearSolver();
+        virtual ~TLinearSolver();
+    
+        virtual std::string getName() = 0;
+        virtual void setMesh(std::map<size_t, TElement*> &connectivities);
+        virtual void analyze(TSparseMatrix *K) = 0;
+        virtual void factorize(TSparseMatrix *K) = 0;
+        virtual void solve(gsl_vector *b, gsl_vector *x) = 0;
+        virtual void solveMany(std::vector<gsl_vector *> &b, std::vector<gsl_vector *> &x);
+        virtual size_t getFactorSize();
+    
+        void setOptions(SSolverOptions options);
+        void setCheckpoint(TCheckpoint *checkpoint);
+        size_t getIterations();
+        double getResidual();
+        bool hasConverged();
+    
+        static void registerSolver(std::string name, TLinearSolver * (*factory)());
+        static std::vector<std::string> getNames();
+        static TLinearSolver * create(std::string name);
+        static std::string selectAuto(TSparseMatrix *K);
+        static size_t getAvailableMemory();
+        static void setMemoryLimit(size_t memoryLimit);
+};
+
+#endif /* TLinearSolver_hpp */
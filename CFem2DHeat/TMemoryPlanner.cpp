@@ -0,0 +1,124 @@
+//
+//  TMemoryPlanner.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#include "TMemoryPlanner.hpp"
+#include "TLinearSolver.hpp"
+#include "TSString.hpp"
+
+#include <math.h>
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+TMemoryPlanner::TMemoryPlanner(size_t amountOfNodes, size_t amountOfElements)
+    : amountOfNodes(amountOfNodes), amountOfElements(amountOfElements) {
+    nonZeros = 3 * amountOfNodes + 2 * amountOfElements;
+}
+
+TMemoryPlanner::~TMemoryPlanner() { }
+
+double TMemoryPlanner::getBase(bool outOfCore) {
+    return PROCESS_BYTES + (outOfCore ? OUT_OF_CORE_ELEMENT_BYTES : ELEMENT_BYTES) * amountOfElements + NODE_BYTES * amountOfNodes;
+}
+
+// CSR values and columns, row starts
+double TMemoryPlanner::getMatrix() {
+    return (double)nonZeros * (sizeof(double) + sizeof(size_t)) + (double)amountOfNodes * sizeof(size_t);
+}
+
+/**
+ * Storage of the solver besides K
+ **/
+double TMemoryPlanner::getSolver(string solver) {
+    double n = (double)amountOfNodes;
+    double cholesky = CHOLESKY_FILL * n * log2(max(n, 2.0)) * (sizeof(double) + sizeof(size_t) + 4); // factor and its workspace
+    if (solver == "dense")      return n * (n + 1) / 2 * sizeof(double);
+    if (solver == "skyline")    return SKYLINE_PROFILE * n * sqrt(n) * (sizeof(double) + 0.5);
+    if (solver == "cholesky")   return cholesky;
+    if (solver == "mixed")      return cholesky * 0.6 + 2 * n * sizeof(double);
+    if (solver == "schwarz")    return cholesky + 6 * n * sizeof(double);
+    if (solver == "pcg-ic0")    return (double)(nonZeros + amountOfNodes) / 2 * (sizeof(double) + sizeof(size_t)) + 6 * n * sizeof(double);
+    return 6 * n * sizeof(double); // pcg-jacobi: diagonal and the vectors of the iteration
+}
+
+size_t TMemoryPlanner::estimate(string solver) {
+    double assembly = getBase(false) + ENTRY_BYTES * 9 * amountOfElements + getMatrix() + PATTERN_BYTES * nonZeros;
+    double solve    = getBase(false) + getMatrix() + getSolver(solver);
+    if (solver == "auto") solve = getBase(false) + getMatrix() + SELECTION_BYTES * amountOfNodes;
+    return (size_t)max(assembly, solve);
+}
+
+/**
+ * The entries buffer is never larger than the budget, the CSR file is mapped
+ **/
+size_t TMemoryPlanner::estimateOutOfCore(size_t memoryBudget) {
+    double entries = min((double)memoryBudget, ENTRY_BYTES * 9 * amountOfElements);
+    return (size_t)(getBase(true) + entries + getSolver("pcg-jacobi"));
+}
+
+/**
+ * Memory left for the factorization of the automatic solver when the run
+ * has maxMemory bytes, 0 when not even an in core conjugate gradient fits.
+ * The selection weighs the bare factor, its workspace is kept aside.
+ **/
+size_t TMemoryPlanner::getSolverLimit(size_t maxMemory) {
+    if (estimate("pcg-jacobi") > maxMemory || estimate("auto") > maxMemory) return 0;
+    double factorShare = (double)(sizeof(double) + sizeof(size_t)) / (sizeof(double) + sizeof(size_t) + 4);
+    return (size_t)max(0.0, ((double)maxMemory - getBase(false) - getMatrix()) * factorShare);
+}
+
+/**
+ * Entries buffer of an out of core run of maxMemory bytes, 0 when it does not fit
+ **/
+size_t TMemoryPlanner::getOutOfCoreBudget(size_t maxMemory) {
+    double budget = (double)maxMemory - getBase(true) - getSolver("pcg-jacobi");
+    return budget < (double)MIN_BUDGET ? 0 : (size_t)budget;
+}
+
+size_t TMemoryPlanner::getNonZeros() {
+    return nonZeros;
+}
+
+vector<string> TMemoryPlanner::getSolvers() {
+    vector<string> solvers = TLinearSolver::getNames();
+    if (amountOfNodes > TLinearSolver::DENSE_LIMIT) solvers.erase(remove(solvers.begin(), solvers.end(), "dense"), solvers.end());
+    return solvers;
+}
+
+/**
+ * Amounts line of an input file, false when it is not there
+ **/
+bool TMemoryPlanner::readAmounts(string fileName, size_t &amountOfElements, size_t &amountOfNodes) {
+    ifstream inFile(fileName.c_str());
+    string line;
+    while (getline(inFile, line)) {
+        if (line != "Number of Elements & Nodes:") continue;
+        getline(inFile, line);
+        vector<string> tmp = TSString::split(line, " ");
+        if (tmp.empty()) return false;
+        amountOfElements    = atoi(tmp[0].c_str());
+        amountOfNodes       = (tmp.size() > 1) ? atoi(tmp[1].c_str()) : 0;
+        return true;
+    }
+    return false;
+}
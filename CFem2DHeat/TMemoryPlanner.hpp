@@ -0,0 +1,83 @@
+//
+//  TMemoryPlanner.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#ifndef TMemoryPlanner_hpp
+#define TMemoryPlanner_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/**
+ * Peak memory of a run from the amounts of nodes and elements, before
+ * anything is read (--max-memory=<MB>, estimates printed with -v)
+ * The non zeros of K come from the degree of a triangle mesh (Euler:
+ * edges = nodes + elements, nnz = nodes + 2 edges). The peak is the larger
+ * of two moments:
+ * assembly     elements + (row, column, value) entries + K + its pattern
+ * solve        elements + K + the storage of the solver
+ * The automatic solver ("auto") adds the selection: adjacency, ordering
+ * and the symbolic analysis of the cholesky probe.
+ * Out of core the elements are released and the entries are spilled to disk
+ * every time they reach the memory budget.
+ * The constants are measured against the peak resident size, the tracked
+ * allocator of TSMetrics gives the share of the C++ containers (the GSL
+ * matrices of the elements and the GSL vectors use malloc). The fill of
+ * skyline and cholesky is the one of a square 2D mesh so long meshes are
+ * overestimated.
+ **/
+class TMemoryPlanner {
+    private:
+        size_t amountOfNodes;
+        size_t amountOfElements;
+        size_t nonZeros;
+    
+        double getBase(bool outOfCore);
+        double getMatrix();
+        double getSolver(std::string solver);
+    
+    public:
+        static constexpr double PROCESS_BYTES = 8 * 1024 * 1024;    // program and libraries
+        static constexpr double ELEMENT_BYTES = 1550;       // element, its nodes, conditions and GSL matrices, parser maps
+        static constexpr double OUT_OF_CORE_ELEMENT_BYTES = 100;    // parser maps only
+        static constexpr double NODE_BYTES = 64;            // F, A and the flux vectors
+        static constexpr double ENTRY_BYTES = 24 * 1.2;     // (row, column, value), with the growth of the buffers
+        static constexpr double PATTERN_BYTES = 32;         // by non zero while the pattern of K is built
+        static constexpr double SELECTION_BYTES = 1300;     // by node while the automatic solver is selected
+        static constexpr double SKYLINE_PROFILE = 0.6;      // profile / N^1.5 with Reverse Cuthill-McKee
+        static constexpr double CHOLESKY_FILL = 3.2;        // factor / (N log2 N) with nested dissection
+        static const size_t MIN_BUDGET = 16 * 1024 * 1024;  // smallest out of core entries buffer
+    
+        TMemoryPlanner(size_t amountOfNodes, size_t amountOfElements);
+        virtual ~TMemoryPlanner();
+    
+        size_t estimate(std::string solver);
+        size_t estimateOutOfCore(size_t memoryBudget);
+        size_t getSolverLimit(size_t maxMemory);
+        size_t getOutOfCoreBudget(size_t maxMemory);
+        size_t getNonZeros();
+        std::vector<std::string> getSolvers();
+    
+        static bool readAmounts(std::string fileName, size_t &amountOfElements, size_t &amountOfNodes);
+};
+
+#endif /* TMemoryPlanner_hpp */
@@ -0,0 +1,92 @@
+//
+//  TMixedSolver.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TMixedSolver.hpp"
+
+#include <math.h>
+
+#include "TSMetrics.hpp"
+
+using namespace std;
+
+TMixedSolver::TMixedSolver(TLinearSolver *inner) : inner(inner), K(NULL) { }
+
+TMixedSolver::~TMixedSolver() {
+    delete inner;
+}
+
+string TMixedSolver::getName() {
+    return "mixed (" + inner->getName() + ")";
+}
+
+void TMixedSolver::analyze(TSparseMatrix *K) {
+    size = K->getSize();
+    inner->analyze(K);
+}
+
+void TMixedSolver::factorize(TSparseMatrix *K) {
+    this->K = K;
+    inner->factorize(K);
+}
+
+void TMixedSolver::solve(gsl_vector *b, gsl_vector *x) {
+    size_t maxRefinements = options.maxIterations ? options.maxIterations : MAX_REFINEMENTS;
+    gsl_vector *r = gsl_vector_alloc(size);
+    gsl_vector *d = gsl_vector_alloc(size);
+    
+    double normB = 0;
+    for (size_t i = 0; i < size; i++) normB += gsl_vector_get(b, i) * gsl_vector_get(b, i);
+    normB = sqrt(normB);
+    if (normB == 0) normB = 1;
+    
+    iterations = 0;
+    double lastResidual = HUGE_VAL;
+    while (true) {
+        // r = b - K * x in double
+        K->multiply(x, r);
+        double normR = 0;
+        for (size_t i = 0; i < size; i++) {
+            double value = gsl_vector_get(b, i) - gsl_vector_get(r, i);
+            gsl_vector_set(r, i, value);
+            normR += value * value;
+        }
+        residual = sqrt(normR) / normB;
+        converged = residual <= options.tolerance;
+        if (TSMetrics::isEnabled()) TSMetrics::append("residual", residual);
+        
+        // Stop when converged, out of refinements or not reducing the residual anymore
+        if (converged || iterations >= maxRefinements || residual > 0.5 * lastResidual) break;
+        lastResidual = residual;
+        
+        // Correction from the single precision factor
+        gsl_vector_set_all(d, 0);
+        inner->solve(r, d);
+        for (size_t i = 0; i < size; i++) gsl_vector_set(x, i, gsl_vector_get(x, i) + gsl_vector_get(d, i));
+        iterations++;
+    }
+    
+    gsl_vector_free(r);
+    gsl_vector_free(d);
+}
+
+size_t TMixedSolver::getFactorSize() {
+    return inner->getFactorSize();
+}
@@ -0,0 +1,57 @@
+//
+//  TMixedSolver.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TMixedSolver_hpp
+#define TMixedSolver_hpp
+
+#include <stdio.h>
+
+#include "TLinearSolver.hpp"
+
+/**
+ * Mixed precision solve with iterative refinement
+ * The inner solver factorizes K in single precision (half the memory and
+ * bandwidth of a double factor). Residuals are computed in double with the
+ * assembled K and the correction is solved with the single precision factor:
+ * r = b - K * x
+ * x = x + inner(r)
+ * until |r| <= tolerance * |b|. When the residual stops decreasing the
+ * refinement ends and hasConverged() reports it.
+ **/
+class TMixedSolver : public TLinearSolver {
+    private:
+        TLinearSolver *inner;
+        TSparseMatrix *K;
+    
+    public:
+        static const size_t MAX_REFINEMENTS = 50;
+    
+        TMixedSolver(TLinearSolver *inner);
+        virtual ~TMixedSolver();
+    
+        std::string getName();
+        void analyze(TSparseMatrix *K);
+        void factorize(TSparseMatrix *K);
+        void solve(gsl_vector *b, gsl_vector *x);
+        size_t getFactorSize();
+};
+
+#endif /* TMixedSolver_hpp */
@@ -0,0 +1,100 @@
+//
+//  TModelCache.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TModelCache.hpp"
+#include "TCommandLine.hpp"
+
+using namespace std;
+
+TModelCache::TModelCache(size_t capacity) : capacity(capacity ? capacity : 1) { }
+
+TModelCache::~TModelCache() {
+    list<pair<size_t, SCachedModel *> >::iterator it;
+    for (it = models.begin(); it != models.end(); it++) release(it->second);
+}
+
+/**
+ * The options that change K or how it is factorized are part of the key
+ **/
+size_t TModelCache::getKey(size_t modelHash) {
+    const char *names[] = {"solver", "tolerance", "max-iterations", "threads", "subdomains", "overlap", "no-condensation", "reproducible"};
+    size_t key = modelHash;
+    for (size_t n = 0; n < sizeof(names) / sizeof(names[0]); n++) {
+        string option = string(names[n]) + "=" + (TCommandLine::hasOption(names[n]) ? TCommandLine::getOption(names[n], "") : "-");
+        for (size_t i = 0; i < option.size(); i++) {
+            key ^= (unsigned char)option[i];
+            key *= 1099511628211ULL;
+        }
+    }
+    return key;
+}
+
+SCachedModel * TModelCache::find(size_t key) {
+    list<pair<size_t, SCachedModel *> >::iterator it;
+    for (it = models.begin(); it != models.end(); it++) {
+        if (it->first != key) continue;
+        models.splice(models.begin(), models, it);
+        it->second->hits++;
+        return it->second;
+    }
+    return NULL;
+}
+
+void TModelCache::store(size_t key, SCachedModel *model) {
+    model->hits = 0;
+    model->solution = NULL;
+    models.push_front(make_pair(key, model));
+    while (models.size() > capacity) {
+        release(models.back().second);
+        models.pop_back();
+    }
+}
+
+size_t TModelCache::getSize() {
+    return models.size();
+}
+
+/**
+ * Sections of the input file that changed since the last job (all of them the first time)
+ **/
+vector<unsigned int> TModelCache::getChangedSections(map<unsigned int, size_t> sections) {
+    vector<unsigned int> changed;
+    map<unsigned int, size_t>::iterator it;
+    for (it = sections.begin(); it != sections.end(); it++) {
+        if (lastSections.find(it->first) == lastSections.end() || lastSections[it->first] != it->second) changed.push_back(it->first);
+    }
+    for (it = lastSections.begin(); it != lastSections.end(); it++) {
+        if (sections.find(it->first) == sections.end()) changed.push_back(it->first);
+    }
+    lastSections = sections;
+    return changed;
+}
+
+void TModelCache::release(SCachedModel *model) {
+    if (model->solution != NULL) gsl_vector_free(model->solution);
+    delete model->solver;
+    delete model->condensation;
+    delete model->K;
+    delete model->edges;
+    map<size_t, TElement*>::iterator it;
+    for (it = model->connectivities.begin(); it != model->connectivities.end(); it++) delete it->second;
+    delete model;
+}
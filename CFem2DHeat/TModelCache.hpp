@@ -0,0 +1,79 @@
+//
+//  TModelCache.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TModelCache_hpp
+#define TModelCache_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+
+#include "TBoundary.hpp"
+#include "TCondensation.hpp"
+#include "TLinearSolver.hpp"
+
+/**
+ * A solved model kept by the server for the next jobs
+ * boundary:    the elements with conditioned nodes, the only ones with f contributions
+ * K:           the assembled matrix (the solvers keep using it after factorize)
+ * condensation and solver: the reduced system and its factorization (or preconditioner)
+ * solution:    last solution of the reduced system, the initial guess of the next solve
+ **/
+struct SCachedModel {
+    std::map<size_t, TElement*> connectivities;
+    std::vector<std::pair<size_t, TElement*> > boundary;
+    TBoundary *edges;
+    TSparseMatrix *K;
+    TCondensation *condensation;
+    TLinearSolver *solver;
+    gsl_vector *solution;
+    size_t hits;
+};
+
+/**
+ * Least recently used cache of solved models
+ * The key hashes the geometry, the materials and the condition type of every
+ * node (see TInputParser::getModelHash) with the solver options, so a job
+ * with the same key only differs in its boundary values: K and its
+ * factorization are the same and only F has to be assembled again.
+ **/
+class TModelCache {
+    private:
+        size_t capacity;
+        std::list<std::pair<size_t, SCachedModel *> > models; // most recently used first
+        std::map<unsigned int, size_t> lastSections; // section hashes of the last job
+    
+        void release(SCachedModel *model);
+    
+    public:
+        TModelCache(size_t capacity);
+        virtual ~TModelCache();
+    
+        static size_t getKey(size_t modelHash);
+        SCachedModel * find(size_t key);
+        void store(size_t key, SCachedModel *model);
+        size_t getSize();
+        std::vector<unsigned int> getChangedSections(std::map<unsigned int, size_t> sections);
+};
+
+#endif /* TModelCache_hpp */
@@ -0,0 +1,45 @@
+//
+//  TOutOfCoreSolver.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TOutOfCoreSolver.hpp"
+
+using namespace std;
+
+TOutOfCoreSolver::TOutOfCoreSolver(TDiskMatrix *diskK) : TPCGSolver(JACOBI), diskK(diskK) { }
+
+TOutOfCoreSolver::~TOutOfCoreSolver() { }
+
+string TOutOfCoreSolver::getName() {
+    return "out-of-core pcg-jacobi";
+}
+
+void TOutOfCoreSolver::analyze(TSparseMatrix *) {
+    size = diskK->getSize();
+}
+
+void TOutOfCoreSolver::factorize(TSparseMatrix *) {
+    diagonal.resize(size);
+    for (size_t i = 0; i < size; i++) diagonal[i] = diskK->get(i, i);
+}
+
+void TOutOfCoreSolver::multiply(const vector<double> &x, vector<double> &y) {
+    diskK->multiply(x, y);
+}
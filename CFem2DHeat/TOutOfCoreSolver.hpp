@@ -0,0 +1,52 @@
+//
+//  TOutOfCoreSolver.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TOutOfCoreSolver_hpp
+#define TOutOfCoreSolver_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "TPCGSolver.hpp"
+#include "TDiskMatrix.hpp"
+
+/**
+ * Jacobi preconditioned conjugate gradient over a matrix stored on disk
+ * Only the vectors of the iteration are kept in memory, every product
+ * streams the matrix from its mapped file. The in memory K given to
+ * analyze and factorize is not used (it can be NULL).
+ **/
+class TOutOfCoreSolver : public TPCGSolver {
+    private:
+        TDiskMatrix *diskK;
+    
+        void multiply(const std::vector<double> &x, std::vector<double> &y);
+    
+    public:
+        TOutOfCoreSolver(TDiskMatrix *diskK);
+        virtual ~TOutOfCoreSolver();
+    
+        std::string getName();
+        void analyze(TSparseMatrix *K);
+        void factorize(TSparseMatrix *K);
+};
+
+#endif /* TOutOfCoreSolver_hpp */
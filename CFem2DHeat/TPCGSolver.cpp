@@ -0,0 +1,210 @@
+//
+//  TPCGSolver.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TPCGSolver.hpp"
+
+#include <math.h>
+
+#include "TSMetrics.hpp"
+#include "TSReduction.hpp"
+
+using namespace std;
+
+TPCGSolver::TPCGSolver(unsigned int preconditioner) : preconditioner(preconditioner), K(NULL), pool(NULL) { }
+
+TPCGSolver::~TPCGSolver() {
+    delete pool;
+}
+
+string TPCGSolver::getName() {
+    return preconditioner == IC0 ? "pcg-ic0" : "pcg-jacobi";
+}
+
+/**
+ * The IC0 factor takes the lower triangle pattern of K
+ **/
+void TPCGSolver::analyze(TSparseMatrix *K) {
+    size = K->getSize();
+    if (pool == NULL && size >= TSReduction::PARALLEL_SIZE) pool = new TThreadPool(TThreadPool::getDefaultThreads());
+    if (preconditioner != IC0) return;
+    Lp.assign(size + 1, 0);
+    Li.clear();
+    for (size_t i = 0; i < size; i++) {
+        for (size_t p = K->getRowStart(i); p < K->getRowStart(i + 1); p++)
+            if (K->getColumn(p) <= i) Li.push_back(K->getColumn(p));
+        Lp[i + 1] = Li.size();
+    }
+    Lx.assign(Li.size(), 0);
+}
+
+void TPCGSolver::factorize(TSparseMatrix *K) {
+    this->K = K;
+    diagonal.resize(size);
+    for (size_t i = 0; i < size; i++) diagonal[i] = K->get(i, i);
+    if (preconditioner == IC0) setupIC0();
+}
+
+/**
+ * Incomplete Cholesky by rows, keeping the pattern of K
+ * l(i, k) = (k(i, k) - sum(l(i, j) * l(k, j))) / l(k, k)
+ * l(i, i) = sqrt(k(i, i) - sum(l(i, j)^2))
+ * If a pivot breaks down the diagonal is shifted and the factor is rebuilt.
+ **/
+void TPCGSolver::setupIC0() {
+    for (double shift = 0; ; shift = (shift == 0) ? 1e-3 : shift * 10) {
+        bool broken = false;
+        for (size_t i = 0; i < size && !broken; i++) {
+            for (size_t p = Lp[i]; p < Lp[i + 1]; p++) {
+                size_t k = Li[p];
+                double sum = K->get(i, k) * (k == i ? 1 + shift : 1);
+                // sparse dot of rows i and k over the columns lower than k
+                size_t a = Lp[i], b = Lp[k];
+                while (a < p && b < Lp[k + 1] - 1) {
+                    if (Li[a] == Li[b]) sum -= Lx[a++] * Lx[b++];
+                    else if (Li[a] < Li[b]) a++;
+                    else b++;
+                }
+                if (k < i) {
+                    Lx[p] = sum / Lx[Lp[k + 1] - 1];
+                } else if (sum > 0) {
+                    Lx[p] = sqrt(sum);
+                } else {
+                    broken = true;
+                    break;
+                }
+            }
+        }
+        if (!broken) return;
+    }
+}
+
+/**
+ * z = M^-1 * r
+ **/
+void TPCGSolver::precondition(const vector<double> &r, vector<double> &z) {
+    if (preconditioner != IC0) {
+        TSReduction::parallelRange(size, pool, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) z[i] = r[i] / diagonal[i];
+        });
+        return;
+    }
+    // L * y = r by rows
+    for (size_t i = 0; i < size; i++) {
+        double sum = r[i];
+        for (size_t p = Lp[i]; p < Lp[i + 1] - 1; p++) sum -= Lx[p] * z[Li[p]];
+        z[i] = sum / Lx[Lp[i + 1] - 1];
+    }
+    // Lt * z = y by columns of Lt (rows of L)
+    for (size_t i = size; i-- > 0;) {
+        z[i] /= Lx[Lp[i + 1] - 1];
+        for (size_t p = Lp[i]; p < Lp[i + 1] - 1; p++) z[Li[p]] -= Lx[p] * z[i];
+    }
+}
+
+/**
+ * y = K * x by blocks of rows
+ **/
+void TPCGSolver::multiply(const vector<double> &x, vector<double> &y) {
+    TSReduction::parallelRange(size, pool, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            double sum = 0;
+            for (size_t k = K->getRowStart(i); k < K->getRowStart(i + 1); k++) sum += K->getValue(k) * x[K->getColumn(k)];
+            y[i] = sum;
+        }
+    });
+}
+
+/**
+ * Conjugate gradient from the initial guess x
+ * It stops when |r| <= tolerance * |b| or after maxIterations
+ * A restart takes x, r, p, rz and the iteration from the checkpoint and goes
+ * on exactly as the interrupted solve
+ **/
+void TPCGSolver::solve(gsl_vector *b, gsl_vector *x) {
+    size_t maxIterations = options.maxIterations ? options.maxIterations : 2 * size + 10;
+    vector<double> r(size), z(size), p(size), q(size);
+    
+    // r = b - K * x
+    for (size_t i = 0; i < size; i++) p[i] = gsl_vector_get(x, i);
+    multiply(p, q);
+    for (size_t i = 0; i < size; i++) {
+        r[i] = gsl_vector_get(b, i) - q[i];
+        q[i] = gsl_vector_get(b, i);
+    }
+    double normB = sqrt(TSReduction::dot(q.data(), q.data(), size, pool));
+    if (normB == 0) normB = 1;
+    
+    SCheckpointState state;
+    double rz, rr;
+    if (checkpoint != NULL && checkpoint->load(state, getName(), size) && state.scalars.size() == 2 && state.vectors.size() == 3) {
+        for (size_t i = 0; i < size; i++) gsl_vector_set(x, i, state.vectors[0][i]);
+        r = state.vectors[1];
+        p = state.vectors[2];
+        rz = state.scalars[0];
+        residual = state.scalars[1];
+        iterations = state.iterations;
+    } else {
+        precondition(r, z);
+        p = z;
+        rz = TSReduction::dot(r.data(), z.data(), size, pool);
+        rr = TSReduction::dot(r.data(), r.data(), size, pool);
+        iterations = 0;
+        residual = sqrt(rr) / normB;
+    }
+    if (TSMetrics::isEnabled()) TSMetrics::append("residual", residual);
+    while (residual > options.tolerance && iterations < maxIterations) {
+        multiply(p, q);
+        double alpha = rz / TSReduction::dot(p.data(), q.data(), size, pool);
+        TSReduction::parallelRange(size, pool, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                gsl_vector_set(x, i, gsl_vector_get(x, i) + alpha * p[i]);
+                r[i] -= alpha * q[i];
+            }
+        });
+        rr = TSReduction::dot(r.data(), r.data(), size, pool);
+        precondition(r, z);
+        double rzNew = TSReduction::dot(r.data(), z.data(), size, pool);
+        double beta = rzNew / rz;
+        rz = rzNew;
+        TSReduction::parallelRange(size, pool, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) p[i] = z[i] + beta * p[i];
+        });
+        iterations++;
+        residual = sqrt(rr) / normB;
+        if (TSMetrics::isEnabled()) TSMetrics::append("residual", residual);
+        if (checkpoint != NULL && checkpoint->isDue()) {
+            state.solver = getName();
+            state.iterations = iterations;
+            state.scalars = {rz, residual};
+            state.vectors.assign(1, vector<double>(size));
+            for (size_t i = 0; i < size; i++) state.vectors[0][i] = gsl_vector_get(x, i);
+            state.vectors.push_back(r);
+            state.vectors.push_back(p);
+            checkpoint->save(state);
+        }
+    }
+    converged = residual <= options.tolerance;
+    if (checkpoint != NULL) checkpoint->finish();
+}
+
+size_t TPCGSolver::getFactorSize() {
+    return preconditioner == IC0 ? Lx.size() : diagonal.size();
+}
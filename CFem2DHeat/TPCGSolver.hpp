@@ -0,0 +1,67 @@
+//
+//  TPCGSolver.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TPCGSolver_hpp
+#define TPCGSolver_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "TLinearSolver.hpp"
+#include "TThreadPool.hpp"
+
+/**
+ * Preconditioned conjugate gradient
+ * Preconditioners:
+ * JACOBI   the diagonal of K
+ * IC0      incomplete Cholesky with the pattern of K (no fill)
+ * The products by K and the dot products of large problems run on the
+ * worker threads, see TSReduction for --reproducible.
+ **/
+class TPCGSolver : public TLinearSolver {
+    protected:
+        unsigned int preconditioner;
+        TSparseMatrix *K;
+        std::vector<double> diagonal;
+        std::vector<size_t> Lp, Li; // lower triangle of the IC0 factor by rows
+        std::vector<double> Lx;
+        TThreadPool *pool;          // NULL for small problems
+    
+        void setupIC0();
+        virtual void precondition(const std::vector<double> &r, std::vector<double> &z);
+        virtual void multiply(const std::vector<double> &x, std::vector<double> &y);
+    
+    public:
+        static const unsigned int JACOBI = 0;
+        static const unsigned int IC0 = 1;
+        static const unsigned int SCHWARZ = 2;
+    
+        TPCGSolver(unsigned int preconditioner);
+        virtual ~TPCGSolver();
+    
+        std::string getName();
+        void analyze(TSparseMatrix *K);
+        void factorize(TSparseMatrix *K);
+        void solve(gsl_vector *b, gsl_vector *x);
+        size_t getFactorSize();
+};
+
+#endif /* TPCGSolver_hpp */
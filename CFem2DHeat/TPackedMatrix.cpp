@@ -0,0 +1,56 @@
+//
+//  TPackedMatrix.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TPackedMatrix.hpp"
+
+#ifdef CFEM_USE_LAPACKE
+#include <lapacke.h>
+#endif
+
+using namespace std;
+
+TPackedMatrix::TPackedMatrix(size_t size) : TSkyline(size) {
+    for (size_t j = 0; j < size; j++) firstRow[j] = 0;
+    allocate();
+}
+
+TPackedMatrix::~TPackedMatrix() { }
+
+void TPackedMatrix::factorize() {
+#ifdef CFEM_USE_LAPACKE
+    lapack_int info = LAPACKE_dpptrf(LAPACK_COL_MAJOR, 'U', (lapack_int)size, &values[0]);
+    if (info != 0) throw runtime_error("ERROR: Dense matrix is not positive definite.");
+    factorized = true;
+#else
+    TSkyline::factorize();
+#endif
+}
+
+void TPackedMatrix::solve(gsl_vector *b, gsl_vector *x) {
+#ifdef CFEM_USE_LAPACKE
+    if (!factorized) factorize();
+    for (size_t i = 0; i < size; i++) gsl_vector_set(x, i, gsl_vector_get(b, i));
+    LAPACKE_dpptrs(LAPACK_COL_MAJOR, 'U', (lapack_int)size, 1, &values[0], x->data, (lapack_int)size);
+#else
+    TSkyline::solve(b, x);
+#endif
+}
+
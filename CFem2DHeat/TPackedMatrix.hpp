@@ -0,0 +1,47 @@
+//
+//  TPackedMatrix.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TPackedMatrix_hpp
+#define TPackedMatrix_hpp
+
+#include <stdio.h>
+
+#include "TSkyline.hpp"
+
+/**
+ * Dense symmetric matrix in packed storage
+ * It is a skyline whose envelope reaches the first row for every column,
+ * so the values follow the LAPACK upper packed layout:
+ * k(i, j) is at [i + j * (j + 1) / 2] for i <= j
+ * When built with CFEM_USE_LAPACKE the factorization goes to dpptrf/dpptrs
+ * (multithreaded when the BLAS behind LAPACKE is), otherwise the blocked
+ * skyline Cholesky is used.
+ **/
+class TPackedMatrix : public TSkyline {
+    public:
+        TPackedMatrix(size_t size);
+        virtual ~TPackedMatrix();
+    
+        void factorize();
+        void solve(gsl_vector *b, gsl_vector *x);
+};
+
+#endif /* TPackedMatrix_hpp */
@@ -0,0 +1,97 @@
+//
+//  TPipeline.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TPipeline.hpp"
+
+#include <iostream>
+
+#include "TSLog.hpp"
+#include "TSMetrics.hpp"
+
+using namespace std;
+
+TPipeline::TPipeline() : begin(chrono::steady_clock::now()) { }
+
+TPipeline::~TPipeline() {
+    for (size_t i = 0; i < threads.size(); i++) if (threads[i].joinable()) threads[i].join();
+}
+
+/**
+ * Timing the stage and keeping its exception for wait()
+ **/
+void TPipeline::runStage(SStage &stage, function<void(SStage &)> job) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    try {
+        job(stage);
+    } catch (...) {
+        unique_lock<mutex> guard(lock);
+        if (!failure) failure = current_exception();
+    }
+    stage.time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (TSMetrics::isEnabled()) {
+        TSMetrics::addTime(stage.name, stage.time);
+        TSMetrics::addTime(stage.name + ".stall", stage.stall);
+    }
+}
+
+void TPipeline::async(string name, function<void(SStage &)> job) {
+    SStage OStage = { name, 0, 0 };
+    stages.push_back(OStage);
+    threads.push_back(thread(&TPipeline::runStage, this, ref(stages.back()), job));
+}
+
+/**
+ * Stages running on the calling thread rethrow right away
+ **/
+void TPipeline::sync(string name, function<void(SStage &)> job) {
+    SStage OStage = { name, 0, 0 };
+    stages.push_back(OStage);
+    runStage(stages.back(), job);
+    if (failure) wait();
+}
+
+void TPipeline::wait() {
+    for (size_t i = 0; i < threads.size(); i++) if (threads[i].joinable()) threads[i].join();
+    threads.clear();
+    if (failure) {
+        exception_ptr rethrown = failure;
+        failure = nullptr;
+        rethrow_exception(rethrown);
+    }
+}
+
+/**
+ * Seconds since the pipeline was created
+ **/
+double TPipeline::getElapsed() {
+    return chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+}
+
+void TPipeline::printReport() {
+    double sum = 0;
+    TLogLine line(TSLog::INFO, TSLog::GENERAL);
+    line << "Pipeline stages:" << endl;
+    for (size_t i = 0; i < stages.size(); i++) {
+        line << "Stage " << stages[i].name << " time (" << stages[i].time << "s) stall (" << stages[i].stall << "s)" << endl;
+        sum += stages[i].time;
+    }
+    line << "End to end time (" << getElapsed() << "s) sum of stages (" << sum << "s)" << endl;
+}
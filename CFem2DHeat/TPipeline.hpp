@@ -0,0 +1,72 @@
+//
+//  TPipeline.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TPipeline_hpp
+#define TPipeline_hpp
+
+#include <stdio.h>
+#include <string>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <exception>
+#include <chrono>
+
+#include "TBoundedQueue.hpp"
+
+struct SStage {
+    std::string name;
+    double time;    // wall time of the stage in seconds
+    double stall;   // part of it blocked on a queue
+};
+
+/**
+ * Task pipelined driver
+ * async() runs a stage on its own thread and sync() on the calling one, the
+ * stages talk through TBoundedQueue objects. wait() joins the async stages
+ * and rethrows the first exception of any of them.
+ * The report compares the end to end time with the sum of the stage times,
+ * the difference is the time saved by overlapping them.
+ **/
+class TPipeline {
+    private:
+        std::deque<SStage> stages; // a deque keeps the references given to the stages valid
+        std::vector<std::thread> threads;
+        std::exception_ptr failure;
+        std::mutex lock;
+        std::chrono::steady_clock::time_point begin;
+    
+        void runStage(SStage &stage, std::function<void(SStage &)> job);
+    
+    public:
+        TPipeline();
+        virtual ~TPipeline();
+    
+        void async(std::string name, std::function<void(SStage &)> job);
+        void sync(std::string name, std::function<void(SStage &)> job);
+        void wait();
+        double getElapsed();
+        void printReport();
+};
+
+#endif /* TPipeline_hpp */
@@ -0,0 +1,121 @@
+//
+//  TProbes.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TProbes.hpp"
+#include "TSpatialGrid.hpp"
+#include "TSString.hpp"
+
+#include <stdlib.h>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * The probes file is read here, before the input file uses the parser
+ **/
+TProbes::TProbes(string fileName) : fileName(fileName), outside(0) {
+    readProbes();
+}
+
+TProbes::~TProbes() { }
+
+void TProbes::readProbes() {
+    ifstream inFile(fileName.c_str());
+    if (!inFile.is_open()) throw runtime_error("ERROR: Cannot open the probes file " + fileName + ".");
+    string line;
+    while (getline(inFile, line)) {
+        vector<string> tmp = TSString::split(line, " \t\r");
+        if (tmp.empty() || tmp[0][0] == '#') continue;
+        if (tmp.size() < 2) throw runtime_error("ERROR: Wrong probe \"" + line + "\" in " + fileName + ".");
+        SProbe OProbe;
+        size_t first = (tmp.size() >= 3) ? 1 : 0;
+        OProbe.name = first ? tmp[0] : to_string(probes.size() + 1);
+        OProbe.point.x = atof(tmp[first].c_str());
+        OProbe.point.y = atof(tmp[first + 1].c_str());
+        OProbe.element = 0;
+        OProbe.temperature = OProbe.xFlux = OProbe.yFlux = 0;
+        probes.push_back(OProbe);
+    }
+}
+
+/**
+ * Keeping the triangle of an element, its nodes bring their coordinates
+ * (a cached or out of core model has no parser coordinates)
+ **/
+void TProbes::addElement(size_t id, TElement *OElement) {
+    coordinates.insert(OElement->nodes.begin(), OElement->nodes.end());
+    triangles.push_back(OElement->getNodeIds());
+    elements.push_back(id);
+}
+
+/**
+ * Locating every probe and interpolating the nodal values (node id - 1)
+ **/
+void TProbes::evaluate(gsl_vector *A, gsl_vector *xFlux, gsl_vector *yFlux) {
+    TSpatialGrid grid(coordinates, triangles);
+    outside = 0;
+    for (size_t p = 0; p < probes.size(); p++) {
+        SProbe &OProbe = probes[p];
+        size_t triangle;
+        TScalar weights[3];
+        OProbe.temperature = OProbe.xFlux = OProbe.yFlux = 0;
+        if (grid.locate(OProbe.point, triangle, weights)) {
+            vector<size_t> &nodeIds = grid.getTriangle(triangle);
+            for (size_t j = 0; j < 3; j++) {
+                OProbe.temperature += weights[j] * gsl_vector_get(A, nodeIds[j] - 1);
+                OProbe.xFlux       += weights[j] * gsl_vector_get(xFlux, nodeIds[j] - 1);
+                OProbe.yFlux       += weights[j] * gsl_vector_get(yFlux, nodeIds[j] - 1);
+            }
+            OProbe.element = elements[triangle];
+        } else {
+            size_t node = grid.nearest(OProbe.point);
+            OProbe.temperature = gsl_vector_get(A, node - 1);
+            OProbe.xFlux       = gsl_vector_get(xFlux, node - 1);
+            OProbe.yFlux       = gsl_vector_get(yFlux, node - 1);
+            OProbe.element = 0;
+            outside++;
+        }
+    }
+}
+
+/**
+ * One line per probe: name x y element temperature xFlux yFlux
+ **/
+void TProbes::write(string outputName) {
+    ofstream outFile(outputName.c_str());
+    if (!outFile.is_open()) throw runtime_error("ERROR: Cannot write the probes file " + outputName + ".");
+    outFile << "# name x y element temperature xFlux yFlux (element 0: outside, nearest node)" << endl;
+    for (size_t p = 0; p < probes.size(); p++) {
+        SProbe &OProbe = probes[p];
+        outFile << OProbe.name << " " << OProbe.point.x << " " << OProbe.point.y << " " << OProbe.element << " "
+                << OProbe.temperature << " " << OProbe.xFlux << " " << OProbe.yFlux << endl;
+    }
+    outFile.close();
+}
+
+size_t TProbes::getAmountOfProbes() {
+    return probes.size();
+}
+
+size_t TProbes::getOutside() {
+    return outside;
+}
@@ -0,0 +1,73 @@
+//
+//  TProbes.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TProbes_hpp
+#define TProbes_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <gsl/gsl_vector.h>
+
+#include "TElement.hpp"
+
+struct SProbe {
+    std::string name;
+    SNode point;
+    size_t element;         // 0 when the point is outside the mesh
+    TScalar temperature;
+    TScalar xFlux;
+    TScalar yFlux;
+};
+
+/**
+ * Temperature and flux at given points of the solved mesh (--probes=<file>)
+ * Every line of the file is a point, "x y" or "name x y" ('#' comments).
+ * The elements are added while the flux is estimated, then the triangles
+ * are indexed by a uniform grid (TSpatialGrid) and the nodal values are
+ * interpolated with the shape functions of the element containing each
+ * point (the nearest node for the points outside the mesh).
+ **/
+class TProbes {
+    private:
+        std::string fileName;
+        std::vector<SProbe> probes;
+        std::map<size_t, SNode> coordinates;
+        std::vector<std::vector<size_t> > triangles;
+        std::vector<size_t> elements;               // element id of each triangle
+        size_t outside;
+    
+        void readProbes();
+    
+    public:
+        TProbes(std::string fileName);
+        virtual ~TProbes();
+    
+        void addElement(size_t id, TElement *OElement);
+        void evaluate(gsl_vector *A, gsl_vector *xFlux, gsl_vector *yFlux);
+        void write(std::string outputName);
+        size_t getAmountOfProbes();
+        size_t getOutside();
+};
+
+#endif /* TProbes_hpp */
@@ -0,0 +1,237 @@
+//
+//  TRaster.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TRaster.hpp"
+#include "TSpatialGrid.hpp"
+#include "TThreadPool.hpp"
+#include "TSString.hpp"
+
+#include <math.h>
+#include <float.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Size of the grid, "<columns>x<rows>" or "<columns>" (rows from the mesh aspect ratio)
+ **/
+TRaster::TRaster(string size, string format) : columns(0), rows(0), format(format), width(0), height(0), covered(0) {
+    vector<string> tmp = TSString::split(size, "x");
+    if (!tmp.empty()) columns = (size_t)atol(tmp[0].c_str());
+    if (tmp.size() > 1) rows = (size_t)atol(tmp[1].c_str());
+    if (tmp.empty() || tmp.size() > 2 || columns == 0 || (tmp.size() == 2 && rows == 0))
+        throw runtime_error("ERROR: Wrong raster size \"" + size + "\", use --raster=<columns>x<rows>.");
+    if (format != "npy" && format != "raw") throw runtime_error("ERROR: Unknown raster format " + format + ", use npy or raw.");
+}
+
+TRaster::~TRaster() { }
+
+void TRaster::addElement(TElement *OElement) {
+    map<size_t, SNode>::iterator it;
+    for (it = OElement->nodes.begin(); it != OElement->nodes.end(); it++) {
+        if (it->first < 1) throw runtime_error("ERROR: Node out of range in the raster.");
+        if (it->first > coordinates.size()) coordinates.resize(it->first);
+        coordinates[it->first - 1] = it->second;
+    }
+    vector<size_t> nodeIds = OElement->getNodeIds();
+    for (size_t j = 0; j < 3; j++) triangles.push_back(nodeIds[j] - 1);
+}
+
+/**
+ * Pixels whose center is in the bounding box of the triangle, false if there is none
+ * The pixel centers are at (column + 0.5, row + 0.5) pixels from the upper left corner
+ **/
+bool TRaster::getPixelRange(size_t triangle, size_t &firstColumn, size_t &lastColumn, size_t &firstRow, size_t &lastRow) {
+    TScalar minX = HUGE_VAL, maxX = -HUGE_VAL, minY = HUGE_VAL, maxY = -HUGE_VAL;
+    for (size_t j = 0; j < 3; j++) {
+        SNode &node = coordinates[triangles[3 * triangle + j]];
+        TScalar x = (node.x - lower.x) / width - 0.5, y = (upper.y - node.y) / height - 0.5;
+        minX = min(minX, x); maxX = max(maxX, x);
+        minY = min(minY, y); maxY = max(maxY, y);
+    }
+    TScalar c0 = max(ceil(minX), (TScalar)0), c1 = min(floor(maxX), (TScalar)columns - 1);
+    TScalar r0 = max(ceil(minY), (TScalar)0), r1 = min(floor(maxY), (TScalar)rows - 1);
+    if (c0 > c1 || r0 > r1) return false;
+    firstColumn = (size_t)c0; lastColumn = (size_t)c1;
+    firstRow    = (size_t)r0; lastRow    = (size_t)r1;
+    return true;
+}
+
+/**
+ * Interpolating the triangle at the pixel centers of the range inside it
+ * The weights are affine in the pixel center: w = (a + b x + c y) / area
+ **/
+void TRaster::fill(size_t triangle, size_t firstColumn, size_t lastColumn, size_t firstRow, size_t lastRow,
+                   vector<float> &nodalTemperature, vector<float> &nodalFlux) {
+    size_t n0 = triangles[3 * triangle], n1 = triangles[3 * triangle + 1], n2 = triangles[3 * triangle + 2];
+    SNode &p0 = coordinates[n0], &p1 = coordinates[n1], &p2 = coordinates[n2];
+    TScalar area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+    if (area == 0) return;
+    TScalar a0 = (p1.x * p2.y - p2.x * p1.y) / area, b0 = (p1.y - p2.y) / area, c0 = (p2.x - p1.x) / area;
+    TScalar a1 = (p2.x * p0.y - p0.x * p2.y) / area, b1 = (p2.y - p0.y) / area, c1 = (p0.x - p2.x) / area;
+    for (size_t r = firstRow; r <= lastRow; r++) {
+        TScalar y = upper.y - (r + 0.5) * height;
+        for (size_t c = firstColumn; c <= lastColumn; c++) {
+            TScalar x = lower.x + (c + 0.5) * width;
+            TScalar w0 = a0 + b0 * x + c0 * y, w1 = a1 + b1 * x + c1 * y, w2 = 1 - w0 - w1;
+            if (w0 < -TSpatialGrid::TOLERANCE || w1 < -TSpatialGrid::TOLERANCE || w2 < -TSpatialGrid::TOLERANCE) continue;
+            size_t pixel = r * columns + c;
+            temperature[pixel] = (float)(w0 * nodalTemperature[n0] + w1 * nodalTemperature[n1] + w2 * nodalTemperature[n2]);
+            flux[pixel]        = (float)(w0 * nodalFlux[n0] + w1 * nodalFlux[n1] + w2 * nodalFlux[n2]);
+        }
+    }
+}
+
+/**
+ * Nodal values (node id - 1) onto the grid
+ * Binning: every chunk counts its triangles per tile, the counts give every
+ * (tile, chunk) its place in one array of triangles sorted by tile, and the
+ * chunks fill it. The tiles are then filled in parallel, their triangles in
+ * the input order whatever the amount of threads.
+ **/
+void TRaster::rasterize(gsl_vector *A, gsl_vector *xFlux, gsl_vector *yFlux) {
+    size_t amountOfTriangles = triangles.size() / 3;
+    
+    // Bounding box of the mesh and pixel size
+    lower.x = lower.y = HUGE_VAL;
+    upper.x = upper.y = -HUGE_VAL;
+    for (size_t i = 0; i < triangles.size(); i++) {
+        SNode &node = coordinates[triangles[i]];
+        lower.x = min(lower.x, node.x); upper.x = max(upper.x, node.x);
+        lower.y = min(lower.y, node.y); upper.y = max(upper.y, node.y);
+    }
+    if (triangles.empty()) lower.x = lower.y = upper.x = upper.y = 0;
+    if (rows == 0) rows = max((size_t)1, (size_t)round(columns * (upper.y - lower.y) / max(upper.x - lower.x, (TScalar)DBL_MIN)));
+    width  = (upper.x > lower.x) ? (upper.x - lower.x) / columns : 1;
+    height = (upper.y > lower.y) ? (upper.y - lower.y) / rows : 1;
+    
+    vector<float> nodalTemperature(coordinates.size()), nodalFlux(coordinates.size());
+    for (size_t i = 0; i < coordinates.size(); i++) {
+        nodalTemperature[i] = (float)gsl_vector_get(A, i);
+        nodalFlux[i]        = (float)hypot(gsl_vector_get(xFlux, i), gsl_vector_get(yFlux, i));
+    }
+    temperature.assign(columns * rows, numeric_limits<float>::quiet_NaN());
+    flux.assign(columns * rows, numeric_limits<float>::quiet_NaN());
+    
+    TThreadPool pool(TThreadPool::getDefaultThreads());
+    size_t tileColumns = (columns + TILE_SIZE - 1) / TILE_SIZE, tileRows = (rows + TILE_SIZE - 1) / TILE_SIZE;
+    size_t tiles = tileColumns * tileRows;
+    size_t chunks = max((size_t)1, min(amountOfTriangles, (size_t)pool.getSize() * 4));
+    size_t chunkSize = (amountOfTriangles + chunks - 1) / chunks;
+    
+    // Triangles of every chunk by tile
+    vector<size_t> counts(chunks * tiles, 0);
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        size_t firstColumn, lastColumn, firstRow, lastRow;
+        size_t *count = &counts[chunk * tiles];
+        for (size_t t = chunk * chunkSize; t < min((chunk + 1) * chunkSize, amountOfTriangles); t++) {
+            if (!getPixelRange(t, firstColumn, lastColumn, firstRow, lastRow)) continue;
+            for (size_t tr = firstRow / TILE_SIZE; tr <= lastRow / TILE_SIZE; tr++)
+                for (size_t tc = firstColumn / TILE_SIZE; tc <= lastColumn / TILE_SIZE; tc++) count[tr * tileColumns + tc]++;
+        }
+    });
+    
+    // First place of every (tile, chunk), tile major
+    vector<size_t> offsets(tiles * chunks + 1, 0);
+    for (size_t tile = 0; tile < tiles; tile++)
+        for (size_t chunk = 0; chunk < chunks; chunk++)
+            offsets[tile * chunks + chunk + 1] = offsets[tile * chunks + chunk] + counts[chunk * tiles + tile];
+    
+    vector<size_t> bins(offsets.back());
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        size_t firstColumn, lastColumn, firstRow, lastRow;
+        size_t *cursor = &counts[chunk * tiles];
+        for (size_t tile = 0; tile < tiles; tile++) cursor[tile] = offsets[tile * chunks + chunk];
+        for (size_t t = chunk * chunkSize; t < min((chunk + 1) * chunkSize, amountOfTriangles); t++) {
+            if (!getPixelRange(t, firstColumn, lastColumn, firstRow, lastRow)) continue;
+            for (size_t tr = firstRow / TILE_SIZE; tr <= lastRow / TILE_SIZE; tr++)
+                for (size_t tc = firstColumn / TILE_SIZE; tc <= lastColumn / TILE_SIZE; tc++) bins[cursor[tr * tileColumns + tc]++] = t;
+        }
+    });
+    
+    // Every tile by one thread, its triangles clipped to it
+    vector<size_t> tileCovered(tiles, 0);
+    pool.parallelFor(tiles, [&](size_t tile) {
+        size_t tileFirstColumn = (tile % tileColumns) * TILE_SIZE, tileLastColumn = min(tileFirstColumn + TILE_SIZE, columns) - 1;
+        size_t tileFirstRow    = (tile / tileColumns) * TILE_SIZE, tileLastRow    = min(tileFirstRow + TILE_SIZE, rows) - 1;
+        size_t firstColumn, lastColumn, firstRow, lastRow;
+        for (size_t i = offsets[tile * chunks]; i < offsets[(tile + 1) * chunks]; i++) {
+            getPixelRange(bins[i], firstColumn, lastColumn, firstRow, lastRow);
+            fill(bins[i], max(firstColumn, tileFirstColumn), min(lastColumn, tileLastColumn),
+                 max(firstRow, tileFirstRow), min(lastRow, tileLastRow), nodalTemperature, nodalFlux);
+        }
+        for (size_t r = tileFirstRow; r <= tileLastRow; r++)
+            for (size_t c = tileFirstColumn; c <= tileLastColumn; c++) if (!isnan(temperature[r * columns + c])) tileCovered[tile]++;
+    });
+    covered = 0;
+    for (size_t tile = 0; tile < tiles; tile++) covered += tileCovered[tile];
+}
+
+/**
+ * float32 in the byte order of the host (little endian on every supported platform)
+ * NPY: magic, version 1.0, header length and a header padded to 64 bytes
+ **/
+void TRaster::writeField(string fileName, vector<float> &field, bool npy) {
+    ofstream outFile(fileName.c_str(), ios::binary);
+    if (!outFile.is_open()) throw runtime_error("ERROR: Cannot write the raster file " + fileName + ".");
+    if (npy) {
+        string header = "{'descr': '<f4', 'fortran_order': False, 'shape': (" + to_string(rows) + ", " + to_string(columns) + "), }";
+        header.append(63 - (10 + header.size()) % 64, ' ');
+        header += '\n';
+        uint16_t length = (uint16_t)header.size();
+        outFile.write("\x93NUMPY\x01\x00", 8);
+        outFile.put((char)(length & 0xff));
+        outFile.put((char)(length >> 8));
+        outFile << header;
+    }
+    outFile.write((const char *)field.data(), field.size() * sizeof(float));
+    if (!outFile.good()) throw runtime_error("ERROR: Cannot write the raster file " + fileName + ".");
+    outFile.close();
+}
+
+/**
+ * <name>.T.npy and <name>.flux.npy (.raw with --raster-format=raw)
+ **/
+void TRaster::write(string problemName) {
+    writeField(problemName + ".T." + format, temperature, format == "npy");
+    writeField(problemName + ".flux." + format, flux, format == "npy");
+}
+
+string TRaster::getFormat() {
+    return format;
+}
+
+size_t TRaster::getColumns() {
+    return columns;
+}
+
+size_t TRaster::getRows() {
+    return rows;
+}
+
+size_t TRaster::getCovered() {
+    return covered;
+}
@@ -0,0 +1,78 @@
+//
+//  TRaster.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TRaster_hpp
+#define TRaster_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include <gsl/gsl_vector.h>
+
+#include "TElement.hpp"
+
+/**
+ * Temperature and flux magnitude on a regular grid of pixels (--raster=<columns>x<rows>)
+ * The grid covers the bounding box of the mesh, row 0 on top. The
+ * triangles are binned by tiles of TILE_SIZE x TILE_SIZE pixels (a counting
+ * sort by chunks of triangles, one chunk per task) and every tile is filled
+ * by one thread, so no pixel is written by two threads. The nodal values are
+ * interpolated with the barycentric weights of the pixel center, the
+ * pixels outside the mesh are NaN. Both fields are written as float32,
+ * NPY (default) or raw (--raster-format=raw).
+ **/
+class TRaster {
+    private:
+        size_t columns;
+        size_t rows;
+        std::string format;
+        std::vector<SNode> coordinates;     // by node id - 1
+        std::vector<size_t> triangles;      // node ids - 1, three per triangle
+        std::vector<float> temperature;
+        std::vector<float> flux;
+        SNode lower;
+        SNode upper;
+        TScalar width;                      // of a pixel
+        TScalar height;
+        size_t covered;
+    
+        bool getPixelRange(size_t triangle, size_t &firstColumn, size_t &lastColumn, size_t &firstRow, size_t &lastRow);
+        void fill(size_t triangle, size_t firstColumn, size_t lastColumn, size_t firstRow, size_t lastRow,
+                  std::vector<float> &nodalTemperature, std::vector<float> &nodalFlux);
+        void writeField(std::string fileName, std::vector<float> &field, bool npy);
+    
+    public:
+        static const size_t TILE_SIZE = 64;
+    
+        TRaster(std::string size, std::string format);
+        virtual ~TRaster();
+    
+        void addElement(TElement *OElement);
+        void rasterize(gsl_vector *A, gsl_vector *xFlux, gsl_vector *yFlux);
+        void write(std::string problemName);
+        std::string getFormat();
+        size_t getColumns();
+        size_t getRows();
+        size_t getCovered();
+};
+
+#endif /* TRaster_hpp */
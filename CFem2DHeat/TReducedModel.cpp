@@ -0,0 +1,368 @@
+//
+//  TReducedModel.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TReducedModel.hpp"
+#include "TSLog.hpp"
+
+#include <math.h>
+#include <fstream>
+#include <stdexcept>
+
+#include <gsl/gsl_blas.h>
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_linalg.h>
+
+using namespace std;
+
+static const char ROM_MAGIC[8] = {'C', 'F', 'E', 'M', 'R', 'O', 'M', '1'};
+static const size_t ROM_BLOCK_ROWS = 1024; // rows of the residual pieces projected at once
+
+TReducedModel::TReducedModel() : modelHash(0), size(0), factor(1), modes(0), basis(NULL), gram(NULL), Kr(NULL), Fr(NULL), coefficients(NULL) { }
+
+TReducedModel::~TReducedModel() {
+    release();
+}
+
+void TReducedModel::release() {
+    if (basis != NULL) gsl_matrix_free(basis);
+    if (gram != NULL) gsl_matrix_free(gram);
+    if (Kr != NULL) gsl_matrix_free(Kr);
+    if (Fr != NULL) gsl_vector_free(Fr);
+    if (coefficients != NULL) gsl_vector_free(coefficients);
+    for (size_t q = 0; q < reducedOperators.size(); q++) gsl_matrix_free(reducedOperators[q]);
+    for (size_t p = 0; p < pieces.size(); p++) gsl_vector_free(pieces[p].vector);
+    basis = gram = Kr = NULL;
+    Fr = coefficients = NULL;
+    reducedOperators.clear();
+    pieces.clear();
+}
+
+/**
+ * Workspace of the queries
+ **/
+void TReducedModel::allocate() {
+    Kr = gsl_matrix_alloc(modes, modes);
+    Fr = gsl_vector_alloc(modes);
+    coefficients = gsl_vector_alloc(pieces.size() + operators.size() * modes);
+}
+
+/**
+ * Full solutions of the samples, POD basis of their free nodes and projection
+ * The modes are the first singular vectors that leave out less than
+ * energy of the snapshots (sum of the squared singular values), maxModes at most
+ **/
+void TReducedModel::train(TAffineModel &model, vector<SParameters> &samples, size_t maxModes, double energy, size_t modelHash, size_t factor) {
+    release();
+    this->modelHash = modelHash;
+    this->factor    = factor;
+    size   = model.getSize();
+    base   = model.getBase();
+    groups = model.getGroups();
+    size_t amount = samples.size();
+    if (amount == 0) throw runtime_error("ERROR: No samples to train the reduced model.");
+    if (amount > size) throw runtime_error("ERROR: More samples than nodes to train the reduced model.");
+    
+    gsl_matrix *snapshots = gsl_matrix_alloc(size, amount);
+    gsl_vector *A = gsl_vector_alloc(size); gsl_vector_set_all(A, 0);
+    for (size_t s = 0; s < amount; s++) {
+        model.solve(samples[s], A);
+        for (size_t i = 0; i < size; i++) gsl_matrix_set(snapshots, i, s, model.isFixed(i) ? 0 : gsl_vector_get(A, i));
+        TLogLine(TSLog::DEBUG, TSLog::SOLVER) << "Sample " << s + 1 << " solved by " << model.getSolver()->getName() << endl;
+    }
+    gsl_vector_free(A);
+    
+    // Thin SVD, the left singular vectors are left in snapshots
+    gsl_matrix *X = gsl_matrix_alloc(amount, amount), *V = gsl_matrix_alloc(amount, amount);
+    gsl_vector *S = gsl_vector_alloc(amount), *work = gsl_vector_alloc(amount);
+    gsl_linalg_SV_decomp_mod(snapshots, X, V, S, work);
+    double total = 0, kept = 0;
+    singularValues.clear();
+    for (size_t s = 0; s < amount; s++) {
+        singularValues.push_back(gsl_vector_get(S, s));
+        total += gsl_vector_get(S, s) * gsl_vector_get(S, s);
+    }
+    modes = 0;
+    while (modes < amount && (maxModes == 0 || modes < maxModes) && singularValues[modes] > 0 && (total - kept) > energy * total) {
+        kept += singularValues[modes] * singularValues[modes];
+        modes++;
+    }
+    if (modes == 0) modes = 1;
+    basis = gsl_matrix_alloc(size, modes);
+    for (size_t i = 0; i < size; i++)
+        for (size_t c = 0; c < modes; c++) gsl_matrix_set(basis, i, c, gsl_matrix_get(snapshots, i, c));
+    gsl_matrix_free(snapshots);
+    gsl_matrix_free(X);
+    gsl_matrix_free(V);
+    gsl_vector_free(S);
+    gsl_vector_free(work);
+    
+    project(model);
+    allocate();
+}
+
+/**
+ * Residual pieces by blocks of rows: the loads and K_m V, H_m V
+ * Each block adds its share to the Gram matrix and to the reduced pieces
+ **/
+void TReducedModel::project(TAffineModel &model) {
+    operators.clear();
+    vector<TSparseMatrix *> matrices;
+    map<size_t, TSparseMatrix*>::iterator it;
+    for (it = model.getConductivity().begin(); it != model.getConductivity().end(); it++) {
+        operators.push_back(make_pair(TAffineModel::CONDUCTIVITY, it->first));
+        matrices.push_back(it->second);
+    }
+    for (it = model.getConvectivity().begin(); it != model.getConvectivity().end(); it++) {
+        operators.push_back(make_pair(TAffineModel::CONVECTIVITY, it->first));
+        matrices.push_back(it->second);
+    }
+    vector<SAffinePiece> &fullPieces = model.getPieces();
+    size_t amountOfPieces = fullPieces.size(), columns = amountOfPieces + operators.size() * modes;
+    for (size_t p = 0; p < amountOfPieces; p++) {
+        SAffinePiece OPiece = fullPieces[p];
+        OPiece.vector = gsl_vector_alloc(modes); gsl_vector_set_all(OPiece.vector, 0);
+        pieces.push_back(OPiece);
+    }
+    for (size_t q = 0; q < operators.size(); q++) {
+        reducedOperators.push_back(gsl_matrix_alloc(modes, modes));
+        gsl_matrix_set_all(reducedOperators.back(), 0);
+    }
+    gram = gsl_matrix_alloc(columns, columns); gsl_matrix_set_all(gram, 0);
+    
+    for (size_t first = 0; first < size; first += ROM_BLOCK_ROWS) {
+        size_t rows = min(ROM_BLOCK_ROWS, size - first);
+        gsl_matrix *block = gsl_matrix_alloc(rows, columns);
+        gsl_matrix *Vb = gsl_matrix_alloc(rows, modes);
+        for (size_t r = 0; r < rows; r++) {
+            size_t i = first + r;
+            for (size_t c = 0; c < modes; c++) gsl_matrix_set(Vb, r, c, gsl_matrix_get(basis, i, c));
+            for (size_t p = 0; p < amountOfPieces; p++) gsl_matrix_set(block, r, p, gsl_vector_get(fullPieces[p].vector, i));
+            for (size_t q = 0; q < matrices.size(); q++) {
+                for (size_t c = 0; c < modes; c++) {
+                    double sum = 0;
+                    for (size_t e = matrices[q]->getRowStart(i); e < matrices[q]->getRowStart(i + 1); e++)
+                        sum += matrices[q]->getValue(e) * gsl_matrix_get(basis, matrices[q]->getColumn(e), c);
+                    gsl_matrix_set(block, r, amountOfPieces + q * modes + c, sum);
+                }
+            }
+        }
+        gsl_blas_dgemm(CblasTrans, CblasNoTrans, 1, block, block, 1, gram);
+        gsl_matrix *product = gsl_matrix_alloc(modes, columns);
+        gsl_blas_dgemm(CblasTrans, CblasNoTrans, 1, Vb, block, 0, product);
+        for (size_t c = 0; c < modes; c++) {
+            for (size_t p = 0; p < amountOfPieces; p++)
+                gsl_vector_set(pieces[p].vector, c, gsl_vector_get(pieces[p].vector, c) + gsl_matrix_get(product, c, p));
+            for (size_t q = 0; q < operators.size(); q++)
+                for (size_t d = 0; d < modes; d++)
+                    gsl_matrix_set(reducedOperators[q], c, d, gsl_matrix_get(reducedOperators[q], c, d) + gsl_matrix_get(product, c, amountOfPieces + q * modes + d));
+        }
+        gsl_matrix_free(product);
+        gsl_matrix_free(block);
+        gsl_matrix_free(Vb);
+    }
+}
+
+/**
+ * Reduced solution a of the parameters and the relative residual of the
+ * full system it gives (HUGE_VAL when the reduced system is not positive definite)
+ **/
+double TReducedModel::query(SParameters &parameters, gsl_vector *a) {
+    size_t amountOfPieces = pieces.size();
+    gsl_matrix_set_all(Kr, 0);
+    gsl_vector_set_all(Fr, 0);
+    for (size_t p = 0; p < amountOfPieces; p++) {
+        double coefficient = TAffineModel::getCoefficient(pieces[p], parameters);
+        gsl_blas_daxpy(coefficient, pieces[p].vector, Fr);
+        gsl_vector_set(coefficients, p, coefficient);
+    }
+    vector<double> scales(operators.size());
+    for (size_t q = 0; q < operators.size(); q++) {
+        SMaterial &OMaterial = parameters.materials[operators[q].second];
+        scales[q] = (operators[q].first == TAffineModel::CONDUCTIVITY) ? OMaterial.conductivity : OMaterial.convectivity;
+        for (size_t c = 0; c < modes; c++)
+            for (size_t d = 0; d < modes; d++)
+                gsl_matrix_set(Kr, c, d, gsl_matrix_get(Kr, c, d) + scales[q] * gsl_matrix_get(reducedOperators[q], c, d));
+    }
+    
+    gsl_error_handler_t *handler = gsl_set_error_handler_off();
+    int status = gsl_linalg_cholesky_decomp(Kr);
+    if (status == GSL_SUCCESS) status = gsl_linalg_cholesky_solve(Kr, Fr, a);
+    gsl_set_error_handler(handler);
+    if (status != GSL_SUCCESS) return HUGE_VAL;
+    
+    // ||F - K V a||^2 and ||F||^2 from the Gram matrix of the pieces
+    for (size_t q = 0; q < operators.size(); q++)
+        for (size_t c = 0; c < modes; c++) gsl_vector_set(coefficients, amountOfPieces + q * modes + c, -scales[q] * gsl_vector_get(a, c));
+    double residual = 0, load = 0;
+    for (size_t i = 0; i < coefficients->size; i++) {
+        double row = 0;
+        for (size_t j = 0; j < coefficients->size; j++) row += gsl_matrix_get(gram, i, j) * gsl_vector_get(coefficients, j);
+        residual += gsl_vector_get(coefficients, i) * row;
+        if (i < amountOfPieces) {
+            row = 0;
+            for (size_t j = 0; j < amountOfPieces; j++) row += gsl_matrix_get(gram, i, j) * gsl_vector_get(coefficients, j);
+            load += gsl_vector_get(coefficients, i) * row;
+        }
+    }
+    if (load <= 0) return (residual > 0) ? HUGE_VAL : 0;
+    return sqrt(max(residual, 0.0) / load);
+}
+
+/**
+ * Temperatures of the reduced solution (node id - 1)
+ **/
+void TReducedModel::getTemperatures(SParameters &parameters, gsl_vector *a, gsl_vector *A) {
+    gsl_blas_dgemv(CblasNoTrans, 1, basis, a, 0, A);
+    TAffineModel::setFixed(groups, parameters, A);
+}
+
+TScalar TReducedModel::getTemperature(SParameters &parameters, gsl_vector *a, size_t node) {
+    bool fixed = false;
+    TScalar value = 0;
+    for (size_t g = 0; g < groups.size(); g++) {
+        if (groups[g].type != "Temperature") continue;
+        map<size_t, TScalar>::iterator weight = groups[g].weights.find(node);
+        if (weight == groups[g].weights.end()) continue;
+        fixed = true;
+        value += weight->second * parameters.values[g];
+    }
+    if (fixed) return value;
+    for (size_t c = 0; c < modes; c++) value += gsl_matrix_get(basis, node - 1, c) * gsl_vector_get(a, c);
+    return value;
+}
+
+SParameters TReducedModel::parseParameters(string line) {
+    return TAffineModel::parseParameters(line, base, groups, factor);
+}
+
+/**
+ * Binary file: magic, sizes, base parameters, condition blocks, singular
+ * values, basis, reduced operators and pieces and the Gram matrix
+ **/
+void TReducedModel::save(string fileName) {
+    ofstream out(fileName.c_str(), ios::binary);
+    if (!out.is_open()) throw runtime_error("ERROR: Cannot write the reduced model " + fileName + ".");
+    auto putSize   = [&](size_t value) { uint64_t v = value; out.write((const char *)&v, sizeof(v)); };
+    auto putDouble = [&](double value) { out.write((const char *)&value, sizeof(value)); };
+    out.write(ROM_MAGIC, sizeof(ROM_MAGIC));
+    putSize(modelHash); putSize(size); putSize(factor); putSize(modes);
+    putSize(base.materials.size());
+    map<size_t, SMaterial>::iterator material;
+    for (material = base.materials.begin(); material != base.materials.end(); material++) {
+        putSize(material->first); putDouble(material->second.conductivity); putDouble(material->second.convectivity);
+    }
+    putSize(groups.size());
+    for (size_t g = 0; g < groups.size(); g++) {
+        putSize(groups[g].type.size()); out.write(groups[g].type.data(), groups[g].type.size());
+        putDouble(base.values[g]); putSize(groups[g].uniform ? 1 : 0);
+        putSize(groups[g].weights.size());
+        map<size_t, TScalar>::iterator it;
+        for (it = groups[g].weights.begin(); it != groups[g].weights.end(); it++) { putSize(it->first); putDouble(it->second); }
+    }
+    putSize(singularValues.size());
+    for (size_t s = 0; s < singularValues.size(); s++) putDouble(singularValues[s]);
+    for (size_t i = 0; i < size; i++) for (size_t c = 0; c < modes; c++) putDouble(gsl_matrix_get(basis, i, c));
+    putSize(operators.size());
+    for (size_t q = 0; q < operators.size(); q++) {
+        putSize(operators[q].first); putSize(operators[q].second);
+        for (size_t c = 0; c < modes; c++) for (size_t d = 0; d < modes; d++) putDouble(gsl_matrix_get(reducedOperators[q], c, d));
+    }
+    putSize(pieces.size());
+    for (size_t p = 0; p < pieces.size(); p++) {
+        putSize(pieces[p].kind); putSize(pieces[p].material); putSize(pieces[p].group);
+        for (size_t c = 0; c < modes; c++) putDouble(gsl_vector_get(pieces[p].vector, c));
+    }
+    for (size_t i = 0; i < gram->size1; i++) for (size_t j = 0; j < gram->size2; j++) putDouble(gsl_matrix_get(gram, i, j));
+    if (!out.good()) throw runtime_error("ERROR: Cannot write the reduced model " + fileName + ".");
+}
+
+void TReducedModel::load(string fileName) {
+    release();
+    ifstream in(fileName.c_str(), ios::binary);
+    char magic[sizeof(ROM_MAGIC)];
+    if (!in.is_open() || !in.read(magic, sizeof(magic)) || string(magic, sizeof(magic)) != string(ROM_MAGIC, sizeof(ROM_MAGIC)))
+        throw runtime_error("ERROR: Cannot read the reduced model " + fileName + ".");
+    auto getSize   = [&]() { uint64_t v = 0; in.read((char *)&v, sizeof(v)); return (size_t)v; };
+    auto getDouble = [&]() { double v = 0; in.read((char *)&v, sizeof(v)); return v; };
+    modelHash = getSize(); size = getSize(); factor = getSize(); modes = getSize();
+    base = SParameters();
+    for (size_t m = getSize(); m > 0 && in.good(); m--) {
+        size_t id = getSize();
+        base.materials[id].conductivity = getDouble();
+        base.materials[id].convectivity = getDouble();
+    }
+    groups.clear();
+    for (size_t g = getSize(); g > 0 && in.good(); g--) {
+        SConditionGroup OGroup;
+        OGroup.type.resize(getSize());
+        in.read(&OGroup.type[0], OGroup.type.size());
+        OGroup.value   = getDouble();
+        OGroup.uniform = getSize() != 0;
+        for (size_t w = getSize(); w > 0 && in.good(); w--) {
+            size_t node = getSize();
+            OGroup.weights[node] = getDouble();
+        }
+        base.values.push_back(OGroup.value);
+        groups.push_back(OGroup);
+    }
+    singularValues.clear();
+    for (size_t s = getSize(); s > 0 && in.good(); s--) singularValues.push_back(getDouble());
+    if (!in.good() || modes == 0) throw runtime_error("ERROR: Cannot read the reduced model " + fileName + ".");
+    basis = gsl_matrix_alloc(size, modes);
+    for (size_t i = 0; i < size; i++) for (size_t c = 0; c < modes; c++) gsl_matrix_set(basis, i, c, getDouble());
+    operators.clear();
+    for (size_t q = getSize(); q > 0 && in.good(); q--) {
+        unsigned int kind = (unsigned int)getSize();
+        operators.push_back(make_pair(kind, getSize()));
+        reducedOperators.push_back(gsl_matrix_alloc(modes, modes));
+        for (size_t c = 0; c < modes; c++) for (size_t d = 0; d < modes; d++) gsl_matrix_set(reducedOperators.back(), c, d, getDouble());
+    }
+    for (size_t p = getSize(); p > 0 && in.good(); p--) {
+        SAffinePiece OPiece;
+        OPiece.kind     = (unsigned int)getSize();
+        OPiece.material = getSize();
+        OPiece.group    = getSize();
+        OPiece.vector   = gsl_vector_alloc(modes);
+        for (size_t c = 0; c < modes; c++) gsl_vector_set(OPiece.vector, c, getDouble());
+        pieces.push_back(OPiece);
+    }
+    size_t columns = pieces.size() + operators.size() * modes;
+    gram = gsl_matrix_alloc(columns, columns);
+    for (size_t i = 0; i < columns; i++) for (size_t j = 0; j < columns; j++) gsl_matrix_set(gram, i, j, getDouble());
+    if (!in.good()) throw runtime_error("ERROR: Cannot read the reduced model " + fileName + ".");
+    allocate();
+}
+
+size_t TReducedModel::getModelHash() {
+    return modelHash;
+}
+
+size_t TReducedModel::getModes() {
+    return modes;
+}
+
+size_t TReducedModel::getSize() {
+    return size;
+}
+
+vector<double> TReducedModel::getSingularValues() {
+    return singularValues;
+}
@@ -0,0 +1,86 @@
+//
+//  TReducedModel.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TReducedModel_hpp
+#define TReducedModel_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <gsl/gsl_vector.h>
+#include <gsl/gsl_matrix.h>
+
+#include "TAffineModel.hpp"
+
+/**
+ * Reduced order model of a mesh for parametric queries (POD/Galerkin)
+ * Offline: the full solutions of a training sweep (free nodes) give a POD
+ * basis V from their thin SVD, and every affine piece of TAffineModel is
+ * projected on it: V^T K_m V, V^T H_m V and V^T F_piece. The Gram matrix of
+ * the residual pieces (F_piece and K_m V, H_m V columns) is kept too.
+ * Online: the reduced system of a query is summed from the projected
+ * pieces and solved by Cholesky, and the relative residual of the full
+ * system ||F - K V a|| / ||F|| comes from the Gram matrix, so nothing of
+ * the mesh size is touched. Saved in a binary file with the model hash of
+ * the input file it was trained on.
+ **/
+class TReducedModel {
+    private:
+        size_t modelHash;
+        size_t size;
+        size_t factor;
+        size_t modes;
+        SParameters base;
+        std::vector<SConditionGroup> groups;
+        std::vector<double> singularValues;
+        gsl_matrix *basis;                                  // size x modes, 0 at the fixed nodes
+        std::vector<std::pair<unsigned int, size_t> > operators;    // (CONDUCTIVITY or CONVECTIVITY, material)
+        std::vector<gsl_matrix *> reducedOperators;         // modes x modes
+        std::vector<SAffinePiece> pieces;                   // reduced loads (modes)
+        gsl_matrix *gram;                                   // pieces, then the operators by mode
+        gsl_matrix *Kr;
+        gsl_vector *Fr;
+        gsl_vector *coefficients;
+    
+        void project(TAffineModel &model);
+        void allocate();
+        void release();
+    
+    public:
+        TReducedModel();
+        virtual ~TReducedModel();
+    
+        void train(TAffineModel &model, std::vector<SParameters> &samples, size_t maxModes, double energy, size_t modelHash, size_t factor);
+        void save(std::string fileName);
+        void load(std::string fileName);
+        double query(SParameters &parameters, gsl_vector *a);
+        void getTemperatures(SParameters &parameters, gsl_vector *a, gsl_vector *A);
+        TScalar getTemperature(SParameters &parameters, gsl_vector *a, size_t node);
+        SParameters parseParameters(std::string line);
+        size_t getModelHash();
+        size_t getModes();
+        size_t getSize();
+        std::vector<double> getSingularValues();
+};
+
+#endif /* TReducedModel_hpp */
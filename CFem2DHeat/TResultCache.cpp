@@ -0,0 +1,119 @@
+//
+//  TResultCache.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TResultCache.hpp"
+#include "TModelCache.hpp"
+
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+TResultCache::TResultCache(string directory, size_t limit) : directory(directory), limit(limit) {
+    if (!this->directory.empty() && this->directory.back() != '/') this->directory += "/";
+    mkdir(this->directory.c_str(), 0755);
+    struct stat info;
+    if (stat(this->directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+        throw runtime_error("ERROR: Cannot use the cache directory " + directory + ".");
+    }
+}
+
+TResultCache::~TResultCache() { }
+
+/**
+ * Every section of the file (with the condition values) plus the solver options
+ **/
+size_t TResultCache::getKey(map<unsigned int, size_t> sections) {
+    size_t key = 14695981039346656037ULL;
+    map<unsigned int, size_t>::iterator it;
+    for (it = sections.begin(); it != sections.end(); it++) {
+        key ^= it->first;
+        key *= 1099511628211ULL;
+        key ^= it->second;
+        key *= 1099511628211ULL;
+    }
+    return TModelCache::getKey(key);
+}
+
+string TResultCache::getPath(size_t key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016zx", key);
+    return directory + name + ".post.res";
+}
+
+bool TResultCache::copy(string source, string target) {
+    ifstream in(source.c_str(), ios::binary);
+    if (!in.is_open()) return false;
+    ofstream out(target.c_str(), ios::binary);
+    out << in.rdbuf();
+    return out.good();
+}
+
+/**
+ * Copying the stored result of the key to target, false if there is none
+ **/
+bool TResultCache::fetch(size_t key, string target) {
+    string path = getPath(key);
+    if (!copy(path, target)) return false;
+    utime(path.c_str(), NULL); // just used
+    return true;
+}
+
+void TResultCache::store(size_t key, string source) {
+    string path = getPath(key);
+    string temporary = path + "." + to_string(getpid()) + ".tmp";
+    if (!copy(source, temporary) || rename(temporary.c_str(), path.c_str()) != 0) {
+        unlink(temporary.c_str());
+        return; // a result that cannot be cached is still a result
+    }
+    evict();
+}
+
+/**
+ * Removing the least recently used results until the directory fits in the limit
+ **/
+void TResultCache::evict() {
+    vector<pair<time_t, pair<size_t, string> > > results; // last use, size and path
+    size_t total = 0;
+    DIR *folder = opendir(directory.c_str());
+    if (folder == NULL) return;
+    struct dirent *entry;
+    while ((entry = readdir(folder)) != NULL) {
+        string name = entry->d_name;
+        if (name.size() < 9 || name.compare(name.size() - 9, 9, ".post.res") != 0) continue;
+        struct stat info;
+        if (stat((directory + name).c_str(), &info) != 0) continue;
+        results.push_back(make_pair(info.st_mtime, make_pair((size_t)info.st_size, directory + name)));
+        total += info.st_size;
+    }
+    closedir(folder);
+    
+    sort(results.begin(), results.end());
+    for (size_t r = 0; r < results.size() && total > limit; r++) {
+        if (unlink(results[r].second.second.c_str()) == 0) total -= results[r].second.first;
+    }
+}
@@ -0,0 +1,61 @@
+//
+//  TResultCache.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TResultCache_hpp
+#define TResultCache_hpp
+
+#include <stdio.h>
+#include <string>
+#include <map>
+
+/**
+ * Content addressed cache of results on disk (--cache-dir=<path>)
+ * A problem is identified by the hashes of every section of its input file
+ * (normalized, see TInputParser::getSectionHashes) and the solver options,
+ * its .post.res is stored as <key>.post.res in the cache directory.
+ * A job with a stored key gets a copy of it without solving anything.
+ *
+ * The directory is kept under its size limit (--cache-limit=<MB>) removing
+ * the least recently used results, the modification time of a result is
+ * its last use. Files are written to a temporary and renamed so concurrent
+ * jobs never read half a result.
+ **/
+class TResultCache {
+    private:
+        std::string directory;
+        size_t limit;
+    
+        std::string getPath(size_t key);
+        static bool copy(std::string source, std::string target);
+    
+    public:
+        static const size_t DEFAULT_LIMIT_MB = 1024;
+    
+        TResultCache(std::string directory, size_t limit);
+        virtual ~TResultCache();
+    
+        static size_t getKey(std::map<unsigned int, size_t> sections);
+        bool fetch(size_t key, std::string target);
+        void store(size_t key, std::string source);
+        void evict();
+};
+
+#endif /* TResultCache_hpp */
@@ -0,0 +1,127 @@
+//
+//  TSAssembly.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSAssembly.hpp"
+#include "TSGsl.hpp"
+#include "TSLog.hpp"
+
+#include <math.h>
+#include <float.h>
+
+using namespace std;
+
+void TSAssembly::addElement(TElement *OElement, map<size_t, SMaterial> &materials, map<size_t, SCondition> &conditions, gsl_vector *F, function<void(size_t, size_t, double)> addEntry, unsigned int verbosityLevel) {
+    size_t amountOfNPE  = OElement->nodes.size(); // Nodes per element
+    
+    // Getting some element properties
+    TScalar conductivity  = materials[OElement->getMaterialId()].conductivity;
+    
+    // Getting k element conductivity contribution
+    gsl_matrix *ke  = OElement->getKd(conductivity);
+    vector<size_t> nodeIds = OElement->getNodeIds();
+    
+    /**
+     * Convection and flux are integrated over the boundary edges (see TBoundary),
+     * only the fixed temperatures are left here so the elements without
+     * conditioned nodes go straight into K
+     **/
+    if (!OElement->hasConditions()) {
+        if (verbosityLevel >= 3) {
+            TLogLine line(TSLog::TRACE, TSLog::ELEMENT);
+            if (line.isActive()) { line << "Element K: " << endl; TSGsl::gsl_show_matrix(*ke, line.getStream()); line << endl; }
+        }
+        for (size_t j = 0; j < amountOfNPE; j++)
+            for (size_t k = 0; k < amountOfNPE; k++) addEntry(nodeIds[j] - 1, nodeIds[k] - 1, gsl_matrix_get(ke, j, k));
+        gsl_matrix_free(ke);
+        return;
+    }
+    
+    // Getting element boundary condition contributions
+    gsl_vector *fe  = OElement->getF(); // f element contribution (Fix temperature if any)
+    
+    // Printing values Ks and Fs for the element if verbosity >= 3
+    if (verbosityLevel >= 3) {
+        TLogLine line(TSLog::TRACE, TSLog::ELEMENT);
+        if (line.isActive()) {
+            ostream &out = line.getStream();
+            out << "Element K: " << endl; TSGsl::gsl_show_matrix(*ke, out); out << endl;
+            out << "Element F: " << endl; TSGsl::gsl_show_vector(*fe, out); out << endl;
+        }
+    }
+    
+    /**
+     * For each node in the element we get contribution values for the global K/F assembling
+     **/
+    for (size_t j = 0; j < amountOfNPE; j++) {
+        size_t nodeJ = nodeIds[j] - 1;
+        
+        // Fixed temperatures are eliminated so K stays symmetric:
+        // the fixed node row is skipped and its column goes to the free nodes F
+        if (conditions.find(nodeIds[j]) != conditions.end() && (conditions[nodeIds[j]].type == "Temperature")) continue;
+        
+        // Element ke into global K
+        for (size_t k = 0; k < amountOfNPE; k++) {
+            size_t nodeK = nodeIds[k] - 1;
+            if (conditions.find(nodeIds[k]) != conditions.end() && (conditions[nodeIds[k]].type == "Temperature")) {
+                gsl_vector_set(F, nodeJ, gsl_vector_get(F, nodeJ) - gsl_matrix_get(ke, j, k) * gsl_vector_get(fe, k));
+            } else {
+                addEntry(nodeJ, nodeK, gsl_matrix_get(ke, j, k));
+            }
+        }
+    }
+    gsl_matrix_free(ke);
+}
+
+/**
+ * Really poor gradient estimation from temperature distribution
+ * TODO: Research and implement a better approach of flux estimation
+ * For example "Super convergent points for the flux"
+ * This is the contribution of one element to its nodes
+ **/
+void TSAssembly::addFlux(TElement *OElement, map<size_t, SMaterial> &materials, gsl_vector *A, gsl_vector *xFlux, gsl_vector *yFlux, gsl_vector *xFluxC, gsl_vector *yFluxC) {
+    size_t amountOfNPE = OElement->nodes.size();
+    TScalar conductivity = materials[OElement->getMaterialId()].conductivity;
+    double temp = 0;
+    
+    vector<size_t> nodeIds = OElement->getNodeIds();
+    // Getting the avg of nodal temperatures
+    for (size_t j = 0; j < amountOfNPE; j++) {
+        temp += gsl_vector_get(A, nodeIds[j] - 1);
+    }
+    temp /= amountOfNPE;
+    
+    // For each node in element
+    for (size_t j = 0; j < amountOfNPE; j++) {
+        size_t nodeJ = nodeIds[j] - 1;
+        SDiff nDiff = OElement->getCenterDiff(j); // Distance to the centroid
+        double kT = conductivity * (gsl_vector_get(A, nodeJ) - temp); // conductivity * delta temperature
+        
+        if ( fabs(nDiff.x) > DBL_EPSILON ) { // if distance is to small we avoid dividing by 0
+            gsl_vector_set(xFluxC, nodeJ, gsl_vector_get(xFluxC, nodeJ) + 1); // counting node contributions
+            gsl_vector_set(xFlux, nodeJ, gsl_vector_get(xFlux, nodeJ) + (kT / nDiff.x)); // Adding element x flux contribution to the node
+        }
+        
+        if ( fabs(nDiff.y) > DBL_EPSILON ) { // if distance is to small we avoid dividing by 0
+            gsl_vector_set(yFluxC, nodeJ, gsl_vector_get(yFluxC, nodeJ) + 1); // counting node contributions
+            gsl_vector_set(yFlux, nodeJ, gsl_vector_get(yFlux, nodeJ) + (kT / nDiff.y)); // Adding element y flux contribution to the node
+        }
+    }
+}
@@ -0,0 +1,45 @@
+//
+//  TSAssembly.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSAssembly_hpp
+#define TSAssembly_hpp
+
+#include <stdio.h>
+#include <map>
+#include <functional>
+
+#include <gsl/gsl_vector.h>
+
+#include "TInputParser.hpp"
+
+/**
+ * Element contributions shared by the solver and the benchmarks
+ * addElement: k and f of one element into the global K (by entries) and F,
+ *             fixed temperatures are eliminated so K stays symmetric
+ * addFlux:    flux contribution of one element to its nodes from A
+ **/
+class TSAssembly {
+    public:
+        static void addElement(TElement *OElement, std::map<size_t, SMaterial> &materials, std::map<size_t, SCondition> &conditions, gsl_vector *F, std::function<void(size_t, size_t, double)> addEntry, unsigned int verbosityLevel);
+        static void addFlux(TElement *OElement, std::map<size_t, SMaterial> &materials, gsl_vector *A, gsl_vector *xFlux, gsl_vector *yFlux, gsl_vector *xFluxC, gsl_vector *yFluxC);
+};
+
+#endif /* TSAssembly_hpp */
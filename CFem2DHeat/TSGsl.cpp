@@ -21,19 +21,34 @@
 
 #include "TSGsl.hpp"
 
+#include <fstream>
+#include <stdexcept>
+
 using namespace std;
 
-void TSGsl::gsl_show_matrix(gsl_matrix matrix) {
+void TSGsl::gsl_show_matrix(const gsl_matrix &matrix, ostream &out) {
     for (size_t i = 0; i < matrix.size1; i++) {
         for (size_t j = 0; j < matrix.size2; j++) {
-            cout << TSString::ftos(gsl_matrix_get(&matrix,i,j)) << "  ";
+            out << TSString::ftos(gsl_matrix_get(&matrix,i,j)) << "  ";
         }
-        cout << endl;
+        out << '\n';
     }
 }
 
-void TSGsl::gsl_show_vector(gsl_vector vect) {
+void TSGsl::gsl_show_vector(const gsl_vector &vect, ostream &out) {
     for (size_t i = 0; i < vect.size; i++)
-        cout << TSString::ftos(gsl_vector_get(&vect,i)) << "  ";
-    cout << endl;
+        out << TSString::ftos(gsl_vector_get(&vect,i)) << "  ";
+    out << '\n';
+}
+
+/**
+ * Matrix Market array file (one column), the dumps too large for the console
+ **/
+void TSGsl::gsl_save_vector(string fileName, const gsl_vector &vect) {
+    ofstream outFile(fileName.c_str());
+    if (!outFile.is_open()) throw runtime_error("ERROR: Cannot write the file " + fileName + ".");
+    outFile.precision(17);
+    outFile << "%%MatrixMarket matrix array real general" << '\n';
+    outFile << vect.size << " 1" << '\n';
+    for (size_t i = 0; i < vect.size; i++) outFile << gsl_vector_get(&vect, i) << '\n';
 }
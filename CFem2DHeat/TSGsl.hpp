@@ -32,8 +32,9 @@
 
 class TSGsl {
     public:
-        static void gsl_show_matrix(gsl_matrix matrix);
-        static void gsl_show_vector(gsl_vector vect);
+        static void gsl_show_matrix(const gsl_matrix &matrix, std::ostream &out = std::cout);
+        static void gsl_show_vector(const gsl_vector &vect, std::ostream &out = std::cout);
+        static void gsl_save_vector(std::string fileName, const gsl_vector &vect);
 };
 
 #endif /* TSGsl_hpp */
@@ -0,0 +1,219 @@
+//
+//  TSLog.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSLog.hpp"
+
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+#include <stdlib.h>
+
+#include "TCommandLine.hpp"
+
+using namespace std;
+
+unsigned int TSLog::verbosityLevel = 0;
+
+/**
+ * Bounded multiple producer single consumer ring
+ * Every slot has a sequence number: a producer claims the tail position with
+ * a compare and swap and publishes the slot by moving its sequence one ahead,
+ * the writer thread takes it back by moving the sequence a lap ahead
+ **/
+struct SLogSlot {
+    atomic<size_t> sequence;
+    string message;
+};
+
+static const size_t RING_SIZE = 8192; // power of 2
+static const size_t RING_MASK = RING_SIZE - 1;
+static SLogSlot ring[RING_SIZE];
+static atomic<size_t> tail(0);
+static atomic<size_t> written(0);
+static size_t head = 0;
+static atomic<bool> running(false);
+static atomic<bool> stopping(false);
+static thread writer;
+static ofstream logFile;
+static ostream *output = &cout;
+
+// Per category state
+static atomic<size_t> seen[TSLog::CATEGORIES];
+static atomic<size_t> logged[TSLog::CATEGORIES];
+static atomic<size_t> suppressed[TSLog::CATEGORIES];
+static atomic<size_t> dropped[TSLog::CATEGORIES];
+static size_t sampling[TSLog::CATEGORIES];
+static size_t limits[TSLog::CATEGORIES];
+
+static bool push(string &message, bool wait) {
+    size_t position = tail.load(memory_order_relaxed);
+    while (true) {
+        SLogSlot &slot = ring[position & RING_MASK];
+        size_t sequence = slot.sequence.load(memory_order_acquire);
+        long difference = (long)sequence - (long)position;
+        if (difference == 0) {
+            if (tail.compare_exchange_weak(position, position + 1, memory_order_relaxed)) break;
+        } else if (difference < 0) { // full
+            if (!wait) return false;
+            this_thread::yield();
+            position = tail.load(memory_order_relaxed);
+        } else {
+            position = tail.load(memory_order_relaxed);
+        }
+    }
+    SLogSlot &slot = ring[position & RING_MASK];
+    slot.message.swap(message);
+    slot.sequence.store(position + 1, memory_order_release);
+    return true;
+}
+
+static void drain() {
+    while (true) {
+        bool idle = true;
+        while (true) {
+            SLogSlot &slot = ring[head & RING_MASK];
+            if (slot.sequence.load(memory_order_acquire) != head + 1) break;
+            *output << slot.message;
+            string().swap(slot.message);
+            slot.sequence.store(head + RING_SIZE, memory_order_release);
+            head++;
+            written.fetch_add(1, memory_order_release);
+            idle = false;
+        }
+        if (!idle) output->flush();
+        if (idle && stopping) return;
+        if (idle) this_thread::sleep_for(chrono::milliseconds(1));
+    }
+}
+
+/**
+ * Category options like element:10,parse:100
+ **/
+static void parseCategoryOption(string name, size_t values[]) {
+    stringstream option(TCommandLine::getOption(name, ""));
+    string item;
+    while (getline(option, item, ',')) {
+        size_t colon = item.find(':');
+        if (colon == string::npos) throw runtime_error("ERROR: --" + name + " expects category:value pairs.");
+        string category = item.substr(0, colon);
+        unsigned int c = 0;
+        while (c < TSLog::CATEGORIES && TSLog::getCategoryName(c) != category) c++;
+        if (c == TSLog::CATEGORIES) throw runtime_error("ERROR: Unknown log category " + category + ".");
+        values[c] = (size_t)atol(item.substr(colon + 1).c_str());
+    }
+}
+
+void TSLog::configure(unsigned int verbosityLevel) {
+    flush();
+    TSLog::verbosityLevel = verbosityLevel;
+    for (unsigned int c = 0; c < CATEGORIES; c++) {
+        seen[c] = 0; logged[c] = 0; suppressed[c] = 0; dropped[c] = 0;
+        sampling[c] = 1;
+        limits[c] = 0;
+    }
+    limits[ELEMENT] = DEFAULT_ELEMENT_LIMIT;
+    limits[PARSE]   = DEFAULT_PARSE_LIMIT;
+    parseCategoryOption("log-sample", sampling);
+    parseCategoryOption("log-limit", limits);
+    
+    if (logFile.is_open()) logFile.close();
+    output = &cout;
+    if (TCommandLine::hasOption("log")) {
+        logFile.open(TCommandLine::getOption("log", "").c_str());
+        if (!logFile.is_open()) throw runtime_error("ERROR: Cannot write the log file " + TCommandLine::getOption("log", "") + ".");
+        output = &logFile;
+    }
+    
+    if (!running.exchange(true)) {
+        for (size_t i = 0; i < RING_SIZE; i++) ring[i].sequence.store(i, memory_order_relaxed);
+        writer = thread(drain);
+        atexit(stop);
+    }
+}
+
+bool TSLog::accept(unsigned int level, unsigned int category) {
+    if (level > verbosityLevel) return false;
+    if (level == WARNING) return true;
+    size_t n = seen[category].fetch_add(1, memory_order_relaxed);
+    if (n % max(sampling[category], (size_t)1) != 0 || (limits[category] > 0 && logged[category].load(memory_order_relaxed) >= limits[category])) {
+        suppressed[category].fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    logged[category].fetch_add(1, memory_order_relaxed);
+    return true;
+}
+
+void TSLog::write(unsigned int level, unsigned int category, string message) {
+    if (!running) {
+        cout << message;
+        return;
+    }
+    if (!push(message, level <= INFO)) dropped[category].fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * Waiting for the writer to catch up with every message logged so far
+ **/
+void TSLog::flush() {
+    if (!running) return;
+    size_t target = tail.load(memory_order_acquire);
+    while (written.load(memory_order_acquire) < target) this_thread::yield();
+    output->flush();
+}
+
+void TSLog::printSummary() {
+    for (unsigned int c = 0; c < CATEGORIES; c++) {
+        if (suppressed[c] == 0 && dropped[c] == 0) continue;
+        TLogLine(WARNING, GENERAL) << "Log category " << getCategoryName(c) << " messages left out (" << suppressed[c] << ") dropped (" << dropped[c]
+                                   << "), see --log-limit=" << getCategoryName(c) << ":0" << endl;
+    }
+}
+
+void TSLog::stop() {
+    if (!running) return;
+    stopping = true;
+    if (writer.joinable()) writer.join();
+    running = false;
+    stopping = false;
+    output->flush();
+}
+
+string TSLog::getCategoryName(unsigned int category) {
+    static const string names[CATEGORIES] = {"general", "parse", "element", "assembly", "solver", "flux"};
+    return category < CATEGORIES ? names[category] : "unknown";
+}
+
+TLogLine::TLogLine(unsigned int level, unsigned int category) : active(TSLog::accept(level, category)), level(level), category(category) { }
+
+TLogLine::~TLogLine() {
+    if (active) TSLog::write(level, category, stream.str());
+}
+
+bool TLogLine::isActive() {
+    return active;
+}
+
+ostream & TLogLine::getStream() {
+    return stream;
+}
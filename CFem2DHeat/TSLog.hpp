@@ -0,0 +1,104 @@
+//
+//  TSLog.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSLog_hpp
+#define TSLog_hpp
+
+#include <stdio.h>
+#include <string>
+#include <sstream>
+#include <iostream>
+
+/**
+ * Diagnostics of a run by level and category
+ * The messages go to a lock free ring buffer and a background thread writes
+ * them to the console (or to --log=<file>), so the stages do not wait on the
+ * output. Every category can be sampled and limited:
+ * --log-sample=element:10      one of every 10 messages
+ * --log-limit=element:1000     at most 1000 messages (0 is no limit)
+ * The element and parse dumps are limited by default, the amount of messages
+ * left out is reported at the end of the run.
+ * When the ring is full the debug and trace messages are dropped, the rest
+ * wait for the writer.
+ **/
+class TSLog {
+    private:
+        static unsigned int verbosityLevel;
+    
+    public:
+        // Levels, as the -v flags
+        static const unsigned int WARNING = 0;
+        static const unsigned int INFO = 1;
+        static const unsigned int DEBUG = 2;
+        static const unsigned int TRACE = 3;
+    
+        // Categories
+        static const unsigned int GENERAL = 0;
+        static const unsigned int PARSE = 1;
+        static const unsigned int ELEMENT = 2;
+        static const unsigned int ASSEMBLY = 3;
+        static const unsigned int SOLVER = 4;
+        static const unsigned int FLUX = 5;
+        static const unsigned int CATEGORIES = 6;
+    
+        static const size_t DEFAULT_ELEMENT_LIMIT = 100;
+        static const size_t DEFAULT_PARSE_LIMIT = 1000;
+    
+        static void configure(unsigned int verbosityLevel);
+        static inline bool isEnabled(unsigned int level) { return level <= verbosityLevel; }
+        static bool accept(unsigned int level, unsigned int category);
+        static void write(unsigned int level, unsigned int category, std::string message);
+        static void flush();
+        static void printSummary();
+        static void stop();
+        static std::string getCategoryName(unsigned int category);
+};
+
+/**
+ * One message built with <<, it is logged when the line goes out of scope
+ * TLogLine(TSLog::INFO, TSLog::SOLVER) << "Solving..." << std::endl;
+ * Nothing is formatted when the level or the sampling of the category leave it out
+ **/
+class TLogLine {
+    private:
+        bool active;
+        unsigned int level;
+        unsigned int category;
+        std::ostringstream stream;
+    
+    public:
+        TLogLine(unsigned int level, unsigned int category);
+        virtual ~TLogLine();
+    
+        bool isActive();
+        std::ostream & getStream();
+    
+        template <class T> TLogLine & operator<<(const T &value) {
+            if (active) stream << value;
+            return *this;
+        }
+        TLogLine & operator<<(std::ostream & (*manipulator)(std::ostream &)) {
+            if (active) manipulator(stream);
+            return *this;
+        }
+};
+
+#endif /* TSLog_hpp */
@@ -0,0 +1,223 @@
+//
+//  TSMetrics.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSMetrics.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <stdlib.h>
+#include <sys/resource.h>
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+bool TSMetrics::enabled = false;
+bool TSMetrics::tracking = false;
+mutex TSMetrics::lock;
+chrono::steady_clock::time_point TSMetrics::begin = chrono::steady_clock::now();
+map<string, double> TSMetrics::phases;
+map<string, double> TSMetrics::counters;
+map<string, vector<double> > TSMetrics::series;
+
+/**
+ * Every operator new of the process goes through here (new[] and the
+ * nothrow forms end up here too), the calls and bytes are counted while
+ * enabled. While tracking (--metrics or --max-memory) the live bytes and
+ * their peak are kept too, by the size malloc gave to each block, so the
+ * run can tell how much of its peak is C++ containers. The GSL vectors and
+ * matrices use malloc and are not counted.
+ * Blocks allocated before the tracking started can be freed while it is on,
+ * so the live bytes are signed.
+ **/
+static atomic<size_t> allocations(0);
+static atomic<size_t> allocatedBytes(0);
+static atomic<long long> liveBytes(0);
+static atomic<long long> peakBytes(0);
+
+static inline size_t getBlockSize(void *pointer) {
+#ifdef __APPLE__
+    return malloc_size(pointer);
+#else
+    return malloc_usable_size(pointer);
+#endif
+}
+
+void * operator new(size_t size) {
+    void *pointer = malloc(size > 0 ? size : 1);
+    if (pointer == NULL) throw bad_alloc();
+    if (TSMetrics::isEnabled()) {
+        allocations.fetch_add(1, memory_order_relaxed);
+        allocatedBytes.fetch_add(size, memory_order_relaxed);
+    }
+    if (TSMetrics::isTracking()) {
+        long long block = (long long)getBlockSize(pointer);
+        long long live = liveBytes.fetch_add(block, memory_order_relaxed) + block;
+        long long peak = peakBytes.load(memory_order_relaxed);
+        while (live > peak && !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) { }
+    }
+    return pointer;
+}
+
+// Out of line, inlined in the containers of this file GCC takes the free for a mismatched delete
+__attribute__((noinline)) static void release(void *pointer) {
+    if (pointer != NULL && TSMetrics::isTracking()) liveBytes.fetch_sub((long long)getBlockSize(pointer), memory_order_relaxed);
+    free(pointer);
+}
+
+void operator delete(void *pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    release(pointer);
+}
+
+void TSMetrics::enable(bool value) {
+    enabled = value;
+}
+
+/**
+ * Live bytes and their peak (see operator new), the peak starts again from
+ * the live bytes at every reset
+ **/
+void TSMetrics::track(bool value) {
+    tracking = value;
+}
+
+void TSMetrics::reset() {
+    unique_lock<mutex> guard(lock);
+    begin = chrono::steady_clock::now();
+    phases.clear();
+    counters.clear();
+    series.clear();
+    allocations = 0;
+    allocatedBytes = 0;
+    peakBytes = max(liveBytes.load(), 0LL);
+}
+
+void TSMetrics::addTime(string phase, double seconds) {
+    if (!enabled) return;
+    unique_lock<mutex> guard(lock);
+    phases[phase] += seconds;
+}
+
+void TSMetrics::count(string name, double value) {
+    if (!enabled) return;
+    unique_lock<mutex> guard(lock);
+    counters[name] += value;
+}
+
+void TSMetrics::set(string name, double value) {
+    if (!enabled) return;
+    unique_lock<mutex> guard(lock);
+    counters[name] = value;
+}
+
+void TSMetrics::append(string name, double value) {
+    if (!enabled) return;
+    unique_lock<mutex> guard(lock);
+    series[name].push_back(value);
+}
+
+/**
+ * ru_maxrss is in kilobytes on Linux and in bytes on macOS
+ **/
+size_t TSMetrics::getPeakMemory() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;
+#else
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+size_t TSMetrics::getAllocations() {
+    return allocations;
+}
+
+size_t TSMetrics::getAllocatedBytes() {
+    return allocatedBytes;
+}
+
+size_t TSMetrics::getLiveBytes() {
+    return (size_t)max(liveBytes.load(), 0LL);
+}
+
+/**
+ * Largest amount of live bytes since the last reset
+ **/
+size_t TSMetrics::getPeakBytes() {
+    return (size_t)peakBytes.load();
+}
+
+void TSMetrics::writeJson(string fileName, string problemName) {
+    if (!enabled) return;
+    unique_lock<mutex> guard(lock);
+    ofstream outFile(fileName.c_str());
+    if (!outFile.is_open()) throw runtime_error("ERROR: Cannot write the metrics file " + fileName + ".");
+    outFile.precision(9);
+    
+    outFile << "{" << endl;
+    outFile << "  \"problem\": \"" << problemName << "\"," << endl;
+    outFile << "  \"elapsed\": " << chrono::duration<double>(chrono::steady_clock::now() - begin).count() << "," << endl;
+    
+    outFile << "  \"phases\": {";
+    map<string, double>::iterator it;
+    for (it = phases.begin(); it != phases.end(); it++) outFile << (it != phases.begin() ? "," : "") << endl << "    \"" << it->first << "\": " << it->second;
+    outFile << endl << "  }," << endl;
+    
+    outFile << "  \"counters\": {";
+    for (it = counters.begin(); it != counters.end(); it++) outFile << (it != counters.begin() ? "," : "") << endl << "    \"" << it->first << "\": " << it->second;
+    outFile << endl << "  }," << endl;
+    
+    outFile << "  \"series\": {";
+    map<string, vector<double> >::iterator its;
+    for (its = series.begin(); its != series.end(); its++) {
+        outFile << (its != series.begin() ? "," : "") << endl << "    \"" << its->first << "\": [";
+        for (size_t i = 0; i < its->second.size(); i++) outFile << (i ? ", " : "") << its->second[i];
+        outFile << "]";
+    }
+    outFile << endl << "  }," << endl;
+    
+    outFile << "  \"memory\": {" << endl;
+    outFile << "    \"peakResident\": " << getPeakMemory() << "," << endl;
+    outFile << "    \"allocations\": " << getAllocations() << "," << endl;
+    outFile << "    \"allocatedBytes\": " << getAllocatedBytes() << "," << endl;
+    outFile << "    \"peakTracked\": " << getPeakBytes() << endl;
+    outFile << "  }" << endl;
+    outFile << "}" << endl;
+}
+
+TScopedTimer::TScopedTimer(string phase) : phase(phase), running(TSMetrics::isEnabled()) {
+    if (running) start = chrono::steady_clock::now();
+}
+
+TScopedTimer::~TScopedTimer() {
+    if (running) TSMetrics::addTime(phase, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+}
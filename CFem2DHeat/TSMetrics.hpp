@@ -0,0 +1,86 @@
+//
+//  TSMetrics.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSMetrics_hpp
+#define TSMetrics_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+
+/**
+ * Run instrumentation (--metrics[=<file>], <name>.metrics.json by default)
+ * phases:      wall time of the pipeline stages and of the scoped timers
+ * counters:    elements assembled, non zeros, solver iterations, cache hits...
+ * series:      values by iteration, like the residual history
+ * memory:      peak resident size, the amount of operator new calls and bytes
+ *              and the peak of the live operator new bytes (tracked with
+ *              --metrics or --max-memory)
+ * Everything is a no-op behind isEnabled() so the hot loops only pay a branch
+ * when it is off. The peak resident size is the one of the whole process,
+ * in server mode it is the largest of all the jobs solved so far.
+ **/
+class TSMetrics {
+    private:
+        static bool enabled;
+        static bool tracking;
+        static std::mutex lock;
+        static std::chrono::steady_clock::time_point begin;
+        static std::map<std::string, double> phases;
+        static std::map<std::string, double> counters;
+        static std::map<std::string, std::vector<double> > series;
+    
+    public:
+        static void enable(bool value);
+        static inline bool isEnabled() { return enabled; }
+        static void track(bool value);
+        static inline bool isTracking() { return tracking; }
+        static void reset();
+        static void addTime(std::string phase, double seconds);
+        static void count(std::string name, double value = 1);
+        static void set(std::string name, double value);
+        static void append(std::string name, double value);
+        static size_t getPeakMemory();
+        static size_t getAllocations();
+        static size_t getAllocatedBytes();
+        static size_t getLiveBytes();
+        static size_t getPeakBytes();
+        static void writeJson(std::string fileName, std::string problemName);
+};
+
+/**
+ * Wall time of a scope added to a TSMetrics phase
+ **/
+class TScopedTimer {
+    private:
+        std::string phase;
+        bool running;
+        std::chrono::steady_clock::time_point start;
+    
+    public:
+        TScopedTimer(std::string phase);
+        virtual ~TScopedTimer();
+};
+
+#endif /* TSMetrics_hpp */
@@ -0,0 +1,220 @@
+//
+//  TSOrdering.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSOrdering.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Breadth first level structure from a root node
+ * It returns the nodes in visiting order, the depth of the structure and
+ * where the last level begins in the returned vector
+ **/
+static vector<size_t> levelStructure(const vector<vector<size_t> > &adjacency, size_t root, vector<size_t> &mark, size_t stamp, size_t &depth, size_t &lastLevel) {
+    vector<size_t> queue; queue.push_back(root);
+    vector<size_t> level(1, 0);
+    mark[root] = stamp;
+    depth = 0; lastLevel = 0;
+    for (size_t head = 0; head < queue.size(); head++) {
+        size_t node = queue[head];
+        for (size_t k = 0; k < adjacency[node].size(); k++) {
+            size_t next = adjacency[node][k];
+            if (mark[next] == stamp) continue;
+            mark[next] = stamp;
+            queue.push_back(next);
+            level.push_back(level[head] + 1);
+            if (level.back() > depth) { depth = level.back(); lastLevel = queue.size() - 1; }
+        }
+    }
+    return queue;
+}
+
+/**
+ * Reverse Cuthill-McKee ordering
+ * It reduces the bandwidth (and the profile) of the stiffness matrix so the
+ * skyline storage only keeps a thin envelope around the diagonal.
+ * The root of every connected component is a pseudo peripheral node found
+ * by repeating the level structure from the farthest, lowest degree node.
+ *
+ * The returned vector maps the original (zero based) node index to its new position.
+ **/
+vector<size_t> TSOrdering::reverseCuthillMcKee(const vector<vector<size_t> > &adjacency) {
+    size_t size = adjacency.size();
+    vector<size_t> order; order.reserve(size);
+    vector<size_t> mark(size, 0);
+    vector<bool> numbered(size, false);
+    size_t stamp = 0;
+    
+    for (size_t start = 0; start < size; start++) {
+        if (numbered[start]) continue;
+        
+        // Looking for a pseudo peripheral node of the component
+        size_t root = start, depth = 0, lastDepth = 0, lastLevel = 0;
+        vector<size_t> visited = levelStructure(adjacency, root, mark, ++stamp, depth, lastLevel);
+        do {
+            lastDepth = depth;
+            size_t candidate = visited[lastLevel], candidateLevel = lastLevel;
+            for (size_t k = lastLevel; k < visited.size(); k++) {
+                if (adjacency[visited[k]].size() < adjacency[candidate].size()) candidate = visited[k];
+            }
+            vector<size_t> tryVisited = levelStructure(adjacency, candidate, mark, ++stamp, depth, candidateLevel);
+            if (depth > lastDepth) { root = candidate; visited = tryVisited; lastLevel = candidateLevel; }
+        } while (depth > lastDepth);
+        
+        // Cuthill-McKee numbering of the component
+        size_t head = order.size();
+        order.push_back(root); numbered[root] = true;
+        for (; head < order.size(); head++) {
+            size_t node = order[head];
+            vector<size_t> next;
+            for (size_t k = 0; k < adjacency[node].size(); k++) {
+                if (!numbered[adjacency[node][k]]) {
+                    numbered[adjacency[node][k]] = true;
+                    next.push_back(adjacency[node][k]);
+                }
+            }
+            sort(next.begin(), next.end(), [&adjacency](size_t a, size_t b) {
+                return adjacency[a].size() < adjacency[b].size();
+            });
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    
+    // Reversing and inverting the order
+    vector<size_t> position(size);
+    for (size_t i = 0; i < size; i++) position[order[i]] = size - 1 - i;
+    return position;
+}
+
+/**
+ * Nested dissection ordering
+ * Each part of the graph is split by a level structure from a pseudo
+ * peripheral node: the median level is the separator and the levels above
+ * and below it are the two halves. Halves are numbered first and the
+ * separator last, so the Cholesky factor only fills inside the blocks and
+ * in the (small) separator rows. Parts below LEAF_SIZE nodes keep the
+ * breadth first order.
+ *
+ * The returned vector maps the original (zero based) node index to its new position.
+ **/
+vector<size_t> TSOrdering::nestedDissection(const vector<vector<size_t> > &adjacency) {
+    const size_t LEAF_SIZE = 64;
+    size_t size = adjacency.size();
+    vector<size_t> position(size);
+    if (size == 0) return position;
+    vector<size_t> part(size, 0), mark(size, 0), level(size, 0);
+    size_t parts = 0, stamp = 0;
+    
+    // Stack of (nodes of the part, first position of the part)
+    vector<pair<vector<size_t>, size_t> > stack;
+    vector<size_t> all(size);
+    for (size_t i = 0; i < size; i++) all[i] = i;
+    stack.push_back(make_pair(all, 0));
+    
+    while (!stack.empty()) {
+        vector<size_t> nodes = stack.back().first;
+        size_t first = stack.back().second;
+        stack.pop_back();
+        
+        size_t id = ++parts;
+        for (size_t k = 0; k < nodes.size(); k++) part[nodes[k]] = id;
+        
+        // Breadth first search inside the part, twice to get a pseudo peripheral root
+        vector<size_t> queue;
+        size_t root = nodes[0];
+        for (unsigned int pass = 0; pass < 2; pass++) {
+            queue.clear(); queue.push_back(root);
+            mark[root] = ++stamp; level[root] = 0;
+            for (size_t head = 0; head < queue.size(); head++) {
+                size_t node = queue[head];
+                for (size_t k = 0; k < adjacency[node].size(); k++) {
+                    size_t next = adjacency[node][k];
+                    if (part[next] != id || mark[next] == stamp) continue;
+                    mark[next] = stamp; level[next] = level[node] + 1;
+                    queue.push_back(next);
+                }
+            }
+            root = queue.back();
+        }
+        
+        if (nodes.size() <= LEAF_SIZE || level[queue.back()] < 2) {
+            // Leaf: breadth first order, nodes out of this component at the end
+            for (size_t k = 0; k < nodes.size(); k++) if (mark[nodes[k]] != stamp) queue.push_back(nodes[k]);
+            for (size_t k = 0; k < queue.size(); k++) position[queue[k]] = first + k;
+            continue;
+        }
+        
+        // Separator at the level that leaves half of the reached nodes below
+        size_t separatorLevel = level[queue[queue.size() / 2]];
+        vector<size_t> lower, upper, separator;
+        for (size_t k = 0; k < nodes.size(); k++) {
+            size_t node = nodes[k];
+            if (mark[node] != stamp) upper.push_back(node); // other components
+            else if (level[node] < separatorLevel) lower.push_back(node);
+            else if (level[node] > separatorLevel) upper.push_back(node);
+            else separator.push_back(node);
+        }
+        
+        for (size_t k = 0; k < separator.size(); k++) position[separator[k]] = first + lower.size() + upper.size() + k;
+        if (!upper.empty()) stack.push_back(make_pair(upper, first + lower.size()));
+        if (!lower.empty()) stack.push_back(make_pair(lower, first));
+    }
+    return position;
+}
+
+/**
+ * Half bandwidth of the matrix once the given order is applied
+ **/
+size_t TSOrdering::getBandwidth(const vector<vector<size_t> > &adjacency, const vector<size_t> &order) {
+    size_t bandwidth = 0;
+    for (size_t i = 0; i < adjacency.size(); i++) {
+        for (size_t k = 0; k < adjacency[i].size(); k++) {
+            size_t a = order[i], b = order[adjacency[i][k]];
+            bandwidth = max(bandwidth, a > b ? a - b : b - a);
+        }
+    }
+    return bandwidth;
+}
+
+/**
+ * Amount of values in the skyline envelope once the given order is applied
+ * It also estimates the Cholesky flops as the sum of the squared column heights
+ **/
+size_t TSOrdering::getProfile(const vector<vector<size_t> > &adjacency, const vector<size_t> &order, double &flops) {
+    size_t size = adjacency.size();
+    vector<size_t> firstRow(size);
+    for (size_t i = 0; i < size; i++) firstRow[order[i]] = order[i];
+    for (size_t i = 0; i < size; i++) {
+        for (size_t k = 0; k < adjacency[i].size(); k++) {
+            size_t a = order[i], b = order[adjacency[i][k]];
+            if (a < b && a < firstRow[b]) firstRow[b] = a;
+        }
+    }
+    size_t profile = 0; flops = 0;
+    for (size_t j = 0; j < size; j++) {
+        double height = j - firstRow[j] + 1;
+        profile += j - firstRow[j] + 1;
+        flops += height * height;
+    }
+    return profile;
+}
@@ -0,0 +1,36 @@
+//
+//  TSOrdering.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSOrdering_hpp
+#define TSOrdering_hpp
+
+#include <stdio.h>
+#include <vector>
+
+class TSOrdering {
+    public:
+        static std::vector<size_t> reverseCuthillMcKee(const std::vector<std::vector<size_t> > &adjacency);
+        static std::vector<size_t> nestedDissection(const std::vector<std::vector<size_t> > &adjacency);
+        static size_t getBandwidth(const std::vector<std::vector<size_t> > &adjacency, const std::vector<size_t> &order);
+        static size_t getProfile(const std::vector<std::vector<size_t> > &adjacency, const std::vector<size_t> &order, double &flops);
+};
+
+#endif /* TSOrdering_hpp */
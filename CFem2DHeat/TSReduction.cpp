@@ -0,0 +1,86 @@
+//
+//  TSReduction.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#include "TSReduction.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+bool TSReduction::reproducible = false;
+
+void TSReduction::setReproducible(bool reproducible) {
+    TSReduction::reproducible = reproducible;
+}
+
+bool TSReduction::isReproducible() {
+    return reproducible;
+}
+
+/**
+ * Sum of partials[first, last) halving the range, so the rounding does not
+ * grow with the amount of blocks
+ **/
+double TSReduction::pairwise(vector<double> &partials, size_t first, size_t last) {
+    if (last - first == 1) return partials[first];
+    size_t middle = first + (last - first) / 2;
+    return pairwise(partials, first, middle) + pairwise(partials, middle, last);
+}
+
+double TSReduction::dot(const double *x, const double *y, size_t size, TThreadPool *pool) {
+    bool parallel = pool != NULL && pool->getSize() > 1 && size >= PARALLEL_SIZE;
+    if (!reproducible && !parallel) {
+        double sum = 0;
+        for (size_t i = 0; i < size; i++) sum += x[i] * y[i];
+        return sum;
+    }
+    size_t blocks = reproducible ? (size + BLOCK_SIZE - 1) / BLOCK_SIZE : pool->getSize();
+    if (blocks == 0) return 0;
+    size_t blockSize = reproducible ? BLOCK_SIZE : (size + blocks - 1) / blocks;
+    vector<double> partials(blocks, 0);
+    auto job = [&](size_t block) {
+        double sum = 0;
+        for (size_t i = block * blockSize, last = min(size, i + blockSize); i < last; i++) sum += x[i] * y[i];
+        partials[block] = sum;
+    };
+    if (parallel) pool->parallelFor(blocks, job);
+    else for (size_t block = 0; block < blocks; block++) job(block);
+    if (!reproducible) {
+        double sum = 0;
+        for (size_t block = 0; block < blocks; block++) sum += partials[block];
+        return sum;
+    }
+    return pairwise(partials, 0, blocks);
+}
+
+/**
+ * job(first, last) over [0, size) by blocks on the pool (element wise loops,
+ * no reduction so the result does not depend on the threads)
+ **/
+void TSReduction::parallelRange(size_t size, TThreadPool *pool, function<void(size_t, size_t)> job) {
+    if (pool == NULL || pool->getSize() == 1 || size < PARALLEL_SIZE) {
+        job(0, size);
+        return;
+    }
+    size_t blocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    pool->parallelFor(blocks, [&](size_t block) { job(block * BLOCK_SIZE, min(size, (block + 1) * BLOCK_SIZE)); });
+}
@@ -0,0 +1,56 @@
+//
+//  TSReduction.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#ifndef TSReduction_hpp
+#define TSReduction_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "TThreadPool.hpp"
+
+/**
+ * Dot products of the iterative solvers on the worker threads
+ * Fast mode: one partial sum per thread added in thread order, so the last
+ * bits of the result change with --threads.
+ * Reproducible mode (--reproducible): partial sums of fixed blocks of
+ * BLOCK_SIZE values added by pairs, the order of the additions only depends
+ * on the length of the vectors and the result is bitwise the same for any
+ * amount of threads.
+ **/
+class TSReduction {
+    private:
+        static bool reproducible;
+    
+        static double pairwise(std::vector<double> &partials, size_t first, size_t last);
+    
+    public:
+        static const size_t BLOCK_SIZE = 4096;      // values of a reproducible partial sum
+        static const size_t PARALLEL_SIZE = 65536;  // shorter vectors stay on the calling thread
+    
+        static void setReproducible(bool reproducible);
+        static bool isReproducible();
+        static double dot(const double *x, const double *y, size_t size, TThreadPool *pool = NULL);
+        static void parallelRange(size_t size, TThreadPool *pool, std::function<void(size_t, size_t)> job);
+};
+
+#endif /* TSReduction_hpp */
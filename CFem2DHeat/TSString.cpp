@@ -23,11 +23,15 @@
 
 using namespace std;
 
-string TSString::ftos(long double value) {
-    string s = to_string(floor(value * 100) / 100);
-    vector<string> vs = split(s, ".");
-    vs[1].erase(vs[1].find_last_not_of('0') + 1, std::string::npos);
-    return (value > 0 ? "+" : (value == 0 ? " " : "")) + vs[0] + "." + (vs[1].empty() ? "00" : vs[1]);
+/**
+ * Value floored to 2 decimals with its sign, like +1.5, -0.34 or  0.00
+ * Formatted in place, it is called for every entry of the matrix dumps
+ **/
+string TSString::ftos(double value) {
+    char buffer[64];
+    int length = snprintf(buffer, sizeof(buffer), "%s%.2f", value > 0 ? "+" : (value == 0 ? " " : ""), floor(value * 100) / 100);
+    if (length > 0 && buffer[length - 1] == '0' && buffer[length - 2] != '0') length--; // x.50 is x.5 but x.00 and x.05 stay
+    return string(buffer, length);
 }
 
 vector<string> TSString::split(string exp, string token) {
@@ -29,7 +29,7 @@
 
 class TSString {
     public:
-        static std::string ftos(long double value);
+        static std::string ftos(double value);
         static std::vector<std::string> split(std::string exp, std::string token = " ");
 };
 
@@ -0,0 +1,211 @@
+//
+//  TSchwarzSolver.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSchwarzSolver.hpp"
+
+#include <algorithm>
+
+#include "TSOrdering.hpp"
+#include "TSReduction.hpp"
+
+using namespace std;
+
+/**
+ * Recursive coordinate bisection of the elements [first, last)
+ * The elements are split at the weighted median of the centroids along
+ * the longest side of their bounding box, so parts can be any number.
+ **/
+static void bisect(vector<pair<SNode, size_t> > &elements, size_t first, size_t last, size_t parts, size_t firstPart, vector<size_t> &elementPart) {
+    if (parts == 1 || last - first < 2) {
+        for (size_t i = first; i < last; i++) elementPart[elements[i].second] = firstPart;
+        return;
+    }
+    TScalar minX = elements[first].first.x, maxX = minX, minY = elements[first].first.y, maxY = minY;
+    for (size_t i = first; i < last; i++) {
+        minX = min(minX, elements[i].first.x); maxX = max(maxX, elements[i].first.x);
+        minY = min(minY, elements[i].first.y); maxY = max(maxY, elements[i].first.y);
+    }
+    bool alongX = (maxX - minX) >= (maxY - minY);
+    size_t leftParts = parts / 2;
+    size_t middle = first + (last - first) * leftParts / parts;
+    nth_element(elements.begin() + first, elements.begin() + middle, elements.begin() + last,
+        [alongX](const pair<SNode, size_t> &a, const pair<SNode, size_t> &b) {
+            return alongX ? a.first.x < b.first.x : a.first.y < b.first.y;
+        });
+    bisect(elements, first, middle, leftParts, firstPart, elementPart);
+    bisect(elements, middle, last, parts - leftParts, firstPart + leftParts, elementPart);
+}
+
+TSchwarzSolver::TSchwarzSolver() : TPCGSolver(SCHWARZ), connectivities(NULL), amountOfSubdomains(0), overlap(1), coarse(NULL) { }
+
+TSchwarzSolver::~TSchwarzSolver() {
+    clear();
+}
+
+void TSchwarzSolver::clear() {
+    for (size_t s = 0; s < localSolvers.size(); s++) {
+        delete localSolvers[s];
+        gsl_vector_free(localR[s]);
+        gsl_vector_free(localZ[s]);
+    }
+    localSolvers.clear(); localR.clear(); localZ.clear();
+    delete coarse; coarse = NULL;
+}
+
+string TSchwarzSolver::getName() {
+    return "schwarz";
+}
+
+void TSchwarzSolver::setMesh(map<size_t, TElement*> &connectivities) {
+    this->connectivities = &connectivities;
+}
+
+/**
+ * Node owners: the lowest subdomain among the elements of the node
+ * A bisection part can end up owning no node (no elements, or all of its
+ * nodes taken by lower parts), those are dropped and the rest renumbered
+ * so no local K is empty and the coarse problem has no zero row.
+ **/
+void TSchwarzSolver::partition(TSparseMatrix *K) {
+    const size_t NONE = (size_t)-1;
+    owner.assign(size, NONE);
+    
+    if (connectivities != NULL && !connectivities->empty()) {
+        vector<pair<SNode, size_t> > elements;
+        vector<TElement *> byIndex;
+        map<size_t, TElement*>::iterator it;
+        for (it = connectivities->begin(); it != connectivities->end(); it++) {
+            elements.push_back(make_pair(it->second->getCenter(), byIndex.size()));
+            byIndex.push_back(it->second);
+        }
+        vector<size_t> elementPart(elements.size());
+        bisect(elements, 0, elements.size(), amountOfSubdomains, 0, elementPart);
+        for (size_t e = 0; e < byIndex.size(); e++) {
+            vector<size_t> nodeIds = byIndex[e]->getNodeIds();
+            for (size_t j = 0; j < nodeIds.size(); j++)
+                owner[nodeIds[j] - 1] = min(owner[nodeIds[j] - 1], elementPart[e]);
+        }
+    }
+    
+    // Without mesh (or for nodes out of any element) chunks of the RCM order
+    vector<vector<size_t> > adjacency = K->getAdjacency();
+    vector<size_t> order = TSOrdering::reverseCuthillMcKee(adjacency);
+    for (size_t i = 0; i < size; i++)
+        if (owner[i] == NONE) owner[i] = order[i] * amountOfSubdomains / size;
+    
+    vector<size_t> renumber(amountOfSubdomains, NONE);
+    for (size_t i = 0; i < size; i++) renumber[owner[i]] = 0;
+    size_t used = 0;
+    for (size_t s = 0; s < amountOfSubdomains; s++) if (renumber[s] != NONE) renumber[s] = used++;
+    for (size_t i = 0; i < size; i++) owner[i] = renumber[owner[i]];
+    amountOfSubdomains = used;
+    
+    // Owned nodes extended with the overlap layers
+    subdomains.assign(amountOfSubdomains, vector<size_t>());
+    vector<size_t> mark(size, NONE);
+    for (size_t i = 0; i < size; i++) subdomains[owner[i]].push_back(i);
+    for (size_t s = 0; s < amountOfSubdomains; s++) {
+        vector<size_t> &nodes = subdomains[s];
+        for (size_t k = 0; k < nodes.size(); k++) mark[nodes[k]] = s;
+        size_t layerBegin = 0;
+        for (size_t layer = 0; layer < overlap; layer++) {
+            size_t layerEnd = nodes.size();
+            for (size_t k = layerBegin; k < layerEnd; k++) {
+                for (size_t a = 0; a < adjacency[nodes[k]].size(); a++) {
+                    size_t next = adjacency[nodes[k]][a];
+                    if (mark[next] == s) continue;
+                    mark[next] = s;
+                    nodes.push_back(next);
+                }
+            }
+            layerBegin = layerEnd;
+        }
+        sort(nodes.begin(), nodes.end());
+    }
+}
+
+void TSchwarzSolver::analyze(TSparseMatrix *K) {
+    size = K->getSize();
+    overlap = options.overlap;
+    if (pool == NULL) pool = new TThreadPool(TThreadPool::getDefaultThreads());
+    // One subdomain per thread, a fixed amount when the result must not depend on the threads
+    unsigned int subdomains = TSReduction::isReproducible() ? REPRODUCIBLE_SUBDOMAINS : max(2u, pool->getSize());
+    amountOfSubdomains = options.subdomains > 0 ? options.subdomains : subdomains;
+    amountOfSubdomains = min(amountOfSubdomains, size);
+    if (connectivities != NULL && !connectivities->empty()) amountOfSubdomains = min(amountOfSubdomains, connectivities->size());
+    amountOfSubdomains = max((size_t)1, amountOfSubdomains);
+    partition(K);
+}
+
+/**
+ * Local factorizations on the worker threads and the coarse problem
+ **/
+void TSchwarzSolver::factorize(TSparseMatrix *K) {
+    this->K = K;
+    diagonal.resize(size);
+    for (size_t i = 0; i < size; i++) diagonal[i] = K->get(i, i);
+    
+    clear();
+    localSolvers.resize(amountOfSubdomains);
+    localR.resize(amountOfSubdomains);
+    localZ.resize(amountOfSubdomains);
+    pool->parallelFor(amountOfSubdomains, [this, K](size_t s) {
+        TSparseMatrix *localK = K->getSubmatrix(subdomains[s]);
+        localSolvers[s] = new TCholeskySolver<double>();
+        localSolvers[s]->analyze(localK);
+        localSolvers[s]->factorize(localK);
+        localR[s] = gsl_vector_alloc(subdomains[s].size());
+        localZ[s] = gsl_vector_alloc(subdomains[s].size());
+        delete localK;
+    });
+    
+    // K0 = Z^T K Z
+    coarse = new TPackedMatrix(amountOfSubdomains);
+    for (size_t i = 0; i < size; i++)
+        for (size_t p = K->getRowStart(i); p < K->getRowStart(i + 1); p++)
+            if (owner[i] <= owner[K->getColumn(p)]) coarse->add(owner[i], owner[K->getColumn(p)], K->getValue(p));
+    coarse->factorize();
+}
+
+void TSchwarzSolver::precondition(const vector<double> &r, vector<double> &z) {
+    pool->parallelFor(amountOfSubdomains, [this, &r](size_t s) {
+        for (size_t k = 0; k < subdomains[s].size(); k++) gsl_vector_set(localR[s], k, r[subdomains[s][k]]);
+        localSolvers[s]->solve(localR[s], localZ[s]);
+    });
+    
+    fill(z.begin(), z.end(), 0);
+    for (size_t s = 0; s < amountOfSubdomains; s++)
+        for (size_t k = 0; k < subdomains[s].size(); k++) z[subdomains[s][k]] += gsl_vector_get(localZ[s], k);
+    
+    // Coarse correction
+    gsl_vector *r0 = gsl_vector_alloc(amountOfSubdomains); gsl_vector_set_all(r0, 0);
+    gsl_vector *z0 = gsl_vector_alloc(amountOfSubdomains);
+    for (size_t i = 0; i < size; i++) gsl_vector_set(r0, owner[i], gsl_vector_get(r0, owner[i]) + r[i]);
+    coarse->solve(r0, z0);
+    for (size_t i = 0; i < size; i++) z[i] += gsl_vector_get(z0, owner[i]);
+    gsl_vector_free(r0); gsl_vector_free(z0);
+}
+
+size_t TSchwarzSolver::getFactorSize() {
+    size_t values = coarse ? coarse->getProfileSize() : 0;
+    for (size_t s = 0; s < localSolvers.size(); s++) values += localSolvers[s]->getFactorSize();
+    return values;
+}
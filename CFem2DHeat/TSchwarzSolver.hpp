@@ -0,0 +1,79 @@
+//
+//  TSchwarzSolver.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSchwarzSolver_hpp
+#define TSchwarzSolver_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <map>
+
+#include "TPCGSolver.hpp"
+#include "TCholeskySolver.hpp"
+#include "TPackedMatrix.hpp"
+#include "TThreadPool.hpp"
+
+/**
+ * Conjugate gradient with a two level additive Schwarz preconditioner
+ * The mesh is split in subdomains by recursive coordinate bisection of the
+ * element centroids (or by chunks of the Reverse Cuthill-McKee order when
+ * there is no mesh). Each subdomain owns the nodes of its elements and is
+ * extended with --overlap layers of neighbour nodes. Its K is factorized
+ * with a sparse Cholesky on a worker thread and kept for every solve.
+ *
+ * M^-1 r = sum(Ri^T Ki^-1 Ri r) + Z K0^-1 Z^T r
+ * where Z has one column per subdomain (the indicator of its owned nodes)
+ * and K0 = Z^T K Z is the coarse problem.
+ * The full overlapping local solutions are added (plain additive Schwarz)
+ * instead of only the owned part of each one (restricted additive Schwarz):
+ * the restricted form is not symmetric and the conjugate gradient needs a
+ * symmetric preconditioner.
+ **/
+class TSchwarzSolver : public TPCGSolver {
+    private:
+        std::map<size_t, TElement*> *connectivities;
+        size_t amountOfSubdomains;
+        size_t overlap;
+        std::vector<size_t> owner;
+        std::vector<std::vector<size_t> > subdomains;
+        std::vector<TCholeskySolver<double> *> localSolvers;
+        std::vector<gsl_vector *> localR;
+        std::vector<gsl_vector *> localZ;
+        TPackedMatrix *coarse;
+    
+        void partition(TSparseMatrix *K);
+        void clear();
+        void precondition(const std::vector<double> &r, std::vector<double> &z);
+    
+    public:
+        static const unsigned int REPRODUCIBLE_SUBDOMAINS = 8;
+    
+        TSchwarzSolver();
+        virtual ~TSchwarzSolver();
+    
+        std::string getName();
+        void setMesh(std::map<size_t, TElement*> &connectivities);
+        void analyze(TSparseMatrix *K);
+        void factorize(TSparseMatrix *K);
+        size_t getFactorSize();
+};
+
+#endif /* TSchwarzSolver_hpp */
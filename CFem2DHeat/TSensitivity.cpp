@@ -0,0 +1,177 @@
+//
+//  TSensitivity.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSensitivity.hpp"
+#include "TSString.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include <gsl/gsl_blas.h>
+
+using namespace std;
+
+TSensitivity::TSensitivity(string definition) : definition(definition), region(false), regionArea(0), weights(NULL), adjoint(NULL), value(0) {
+    size_t colon = definition.find(':');
+    string kind = definition.substr(0, colon);
+    vector<string> tmp = (colon != string::npos) ? TSString::split(definition.substr(colon + 1), ",") : vector<string>();
+    if (kind == "nodes" && !tmp.empty()) {
+        for (size_t i = 0; i < tmp.size(); i++) nodes.push_back((size_t)atol(tmp[i].c_str()));
+    } else if (kind == "region" && tmp.size() == 4) {
+        region = true;
+        lower.x = min(atof(tmp[0].c_str()), atof(tmp[2].c_str())); upper.x = max(atof(tmp[0].c_str()), atof(tmp[2].c_str()));
+        lower.y = min(atof(tmp[1].c_str()), atof(tmp[3].c_str())); upper.y = max(atof(tmp[1].c_str()), atof(tmp[3].c_str()));
+    } else {
+        throw runtime_error("ERROR: Wrong functional \"" + definition + "\", use nodes:<id>,... or region:<x0>,<y0>,<x1>,<y1>.");
+    }
+}
+
+TSensitivity::~TSensitivity() {
+    if (weights != NULL) gsl_vector_free(weights);
+    if (adjoint != NULL) gsl_vector_free(adjoint);
+}
+
+/**
+ * Area of the region elements, a third to each of their nodes
+ **/
+void TSensitivity::addWeights(TElement *OElement) {
+    if (!region) return;
+    SNode center = OElement->getCenter();
+    if (center.x < lower.x || center.x > upper.x || center.y < lower.y || center.y > upper.y) return;
+    vector<size_t> nodeIds = OElement->getNodeIds();
+    for (size_t j = 0; j < nodeIds.size(); j++) areas[nodeIds[j]] += OElement->getArea() / nodeIds.size();
+    regionArea += OElement->getArea();
+}
+
+/**
+ * c (node id - 1), the right hand side of the adjoint system
+ **/
+gsl_vector * TSensitivity::getWeights(size_t amountOfNodes) {
+    if (weights != NULL) gsl_vector_free(weights);
+    weights = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(weights, 0);
+    if (region) {
+        if (regionArea <= 0) throw runtime_error("ERROR: No element in the functional region " + definition + ".");
+        map<size_t, TScalar>::iterator it;
+        for (it = areas.begin(); it != areas.end(); it++) gsl_vector_set(weights, it->first - 1, it->second / regionArea);
+        return weights;
+    }
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i] < 1 || nodes[i] > amountOfNodes) throw runtime_error("ERROR: Node " + to_string(nodes[i]) + " of the functional does not exist.");
+        gsl_vector_set(weights, nodes[i] - 1, gsl_vector_get(weights, nodes[i] - 1) + 1.0 / nodes.size());
+    }
+    return weights;
+}
+
+/**
+ * The solution of K l = c, the fixed temperature rows are identity rows so
+ * they get c there: that is the direct dJ/dT of those nodes
+ **/
+void TSensitivity::setAdjoint(gsl_vector *adjoint, map<size_t, SCondition> &conditions) {
+    if (this->adjoint != NULL) gsl_vector_free(this->adjoint);
+    this->adjoint = adjoint;
+    map<size_t, SCondition>::iterator it;
+    for (it = conditions.begin(); it != conditions.end(); it++) {
+        if (it->second.type != "Temperature") continue;
+        temperature[it->first] = gsl_vector_get(weights, it->first - 1);
+        gsl_vector_set(adjoint, it->first - 1, 0);
+    }
+}
+
+/**
+ * Element terms: K is linear in the conductivity (dK/dk = ke / k) and the
+ * fixed temperature columns went to F (dF/dT = -ke column)
+ **/
+void TSensitivity::addElement(TElement *OElement, map<size_t, SMaterial> &materials, gsl_vector *A) {
+    vector<size_t> nodeIds = OElement->getNodeIds();
+    size_t material = OElement->getMaterialId();
+    gsl_matrix *ke = OElement->getKd(materials[material].conductivity);
+    gsl_matrix *ku = OElement->getKd(1);
+    TScalar term = 0;
+    for (size_t j = 0; j < nodeIds.size(); j++) {
+        TScalar l = gsl_vector_get(adjoint, nodeIds[j] - 1);
+        if (l == 0) continue;
+        for (size_t k = 0; k < nodeIds.size(); k++) {
+            term += l * gsl_matrix_get(ku, j, k) * gsl_vector_get(A, nodeIds[k] - 1);
+            map<size_t, TScalar>::iterator fixed = temperature.find(nodeIds[k]);
+            if (fixed != temperature.end()) fixed->second -= l * gsl_matrix_get(ke, j, k);
+        }
+    }
+    conductivity[material] -= term;
+    gsl_matrix_free(ke);
+    gsl_matrix_free(ku);
+}
+
+/**
+ * Edge terms (see TBoundary): F gets h L / 2 Ta (q L / 2) at each node and
+ * K gets h L / 6 [2 1; 1 2], and the value of J
+ **/
+void TSensitivity::addBoundary(TBoundary *edges, gsl_vector *A) {
+    SEdgeList &convection = edges->getEdges(TBoundary::CONVECTION);
+    for (size_t e = 0; e < convection.first.size(); e++) {
+        size_t i = convection.first[e], j = convection.second[e];
+        TScalar li = gsl_vector_get(adjoint, i - 1), lj = gsl_vector_get(adjoint, j - 1);
+        TScalar ai = gsl_vector_get(A, i - 1), aj = gsl_vector_get(A, j - 1);
+        TScalar half = convection.length[e] / 2, sixth = convection.length[e] / 6;
+        convectivity[convection.material[e]] += li * half * convection.firstValue[e] + lj * half * convection.secondValue[e]
+                                              - sixth * (li * (2 * ai + aj) + lj * (ai + 2 * aj));
+        ambient[i] += li * convection.coefficient[e] * half;
+        ambient[j] += lj * convection.coefficient[e] * half;
+    }
+    SEdgeList &edgeFlux = edges->getEdges(TBoundary::FLUX);
+    for (size_t e = 0; e < edgeFlux.first.size(); e++) {
+        size_t i = edgeFlux.first[e], j = edgeFlux.second[e];
+        flux[i] += gsl_vector_get(adjoint, i - 1) * edgeFlux.length[e] / 2;
+        flux[j] += gsl_vector_get(adjoint, j - 1) * edgeFlux.length[e] / 2;
+    }
+    double dot;
+    gsl_blas_ddot(weights, A, &dot);
+    value = dot;
+}
+
+/**
+ * The parser keeps k / factor, h / factor^2 and q factor (see TInputParser),
+ * the sensitivities are written by the values of the input file
+ **/
+void TSensitivity::write(string fileName) {
+    TScalar factor = TInputParser::getFactor();
+    ofstream outFile(fileName.c_str());
+    if (!outFile.is_open()) throw runtime_error("ERROR: Cannot write the sensitivity file " + fileName + ".");
+    outFile << "# Adjoint sensitivities of J = mean temperature (" << definition << ")" << endl;
+    outFile << "J " << value << endl;
+    outFile << "# material dJ/dk dJ/dh" << endl;
+    map<size_t, TScalar>::iterator it;
+    for (it = conductivity.begin(); it != conductivity.end(); it++)
+        outFile << "Material " << it->first << " " << it->second / factor << " " << convectivity[it->first] / (factor * factor) << endl;
+    outFile << "# node dJ/dT (fixed temperature)" << endl;
+    for (it = temperature.begin(); it != temperature.end(); it++) outFile << "Temperature " << it->first << " " << it->second << endl;
+    outFile << "# node dJ/dq" << endl;
+    for (it = flux.begin(); it != flux.end(); it++) outFile << "Flux " << it->first << " " << it->second * factor << endl;
+    outFile << "# node dJ/dT ambient" << endl;
+    for (it = ambient.begin(); it != ambient.end(); it++) outFile << "Convection " << it->first << " " << it->second << endl;
+    outFile.close();
+}
+
+TScalar TSensitivity::getValue() {
+    return value;
+}
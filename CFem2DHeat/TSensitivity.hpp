@@ -0,0 +1,81 @@
+//
+//  TSensitivity.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSensitivity_hpp
+#define TSensitivity_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <gsl/gsl_vector.h>
+
+#include "TElement.hpp"
+#include "TInputParser.hpp"
+#include "TBoundary.hpp"
+
+/**
+ * Adjoint sensitivities of a functional J = c^T A (--functional=<definition>)
+ * nodes:<id>,<id>,...             mean temperature at the nodes
+ * region:<x0>,<y0>,<x1>,<y1>      mean temperature over the elements with
+ *                                 their centroid in the box (area weighted)
+ * With R(A, p) = K A - F = 0 on the free nodes, one extra solve K l = c with
+ * the factorized (or preconditioned) K gives dJ/dp = l^T (dF/dp - dK/dp A)
+ * for every parameter, the fixed temperature rows of l are left out of it.
+ * The element terms are added while the flux is estimated, the edge terms
+ * come from the boundary (TBoundary). Saved as <name>.sensitivity, by the
+ * values as written in the input file (any unit): dJ/dk and dJ/dh by
+ * material, dJ/dT by fixed temperature node, dJ/dq by flux node and dJ/dT
+ * ambient by convection node.
+ **/
+class TSensitivity {
+    private:
+        std::string definition;
+        std::vector<size_t> nodes;
+        bool region;
+        SNode lower;
+        SNode upper;
+        std::map<size_t, TScalar> areas;        // region area by node id, a third of its elements
+        TScalar regionArea;
+        gsl_vector *weights;                    // c
+        gsl_vector *adjoint;                    // l, 0 at the fixed temperature nodes
+        TScalar value;
+        std::map<size_t, TScalar> conductivity; // by material
+        std::map<size_t, TScalar> convectivity;
+        std::map<size_t, TScalar> temperature;  // by node id
+        std::map<size_t, TScalar> flux;
+        std::map<size_t, TScalar> ambient;
+    
+    public:
+        TSensitivity(std::string definition);
+        virtual ~TSensitivity();
+    
+        void addWeights(TElement *OElement);
+        gsl_vector * getWeights(size_t amountOfNodes);
+        void setAdjoint(gsl_vector *adjoint, std::map<size_t, SCondition> &conditions);
+        void addElement(TElement *OElement, std::map<size_t, SMaterial> &materials, gsl_vector *A);
+        void addBoundary(TBoundary *edges, gsl_vector *A);
+        void write(std::string fileName);
+        TScalar getValue();
+};
+
+#endif /* TSensitivity_hpp */
@@ -0,0 +1,159 @@
+//
+//  TSkyline.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSkyline.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Dot product of two contiguous column segments
+ **/
+static inline double dot(const double *a, const double *b, size_t n) {
+    double sum = 0;
+    for (size_t k = 0; k < n; k++) sum += a[k] * b[k];
+    return sum;
+}
+
+TSkyline::TSkyline(size_t size) : size(size), firstRow(size), factorized(false) {
+    for (size_t j = 0; j < size; j++) firstRow[j] = j;
+}
+
+TSkyline::~TSkyline() { }
+
+/**
+ * Pointer to the first stored value of the column j
+ * so column(j)[i - firstRow[j]] is the entry (i, j)
+ **/
+double * TSkyline::column(size_t j) {
+    return &values[columnStart[j]];
+}
+
+/**
+ * Extending the envelope so it includes the entry (i, j)
+ * It must be called for every non zero before allocate()
+ **/
+void TSkyline::addToEnvelope(size_t i, size_t j) {
+    if (i > j) swap(i, j);
+    if (i < firstRow[j]) firstRow[j] = i;
+}
+
+/**
+ * Memory alloc of the profile once the envelope is known
+ **/
+void TSkyline::allocate() {
+    columnStart.assign(size + 1, 0);
+    for (size_t j = 0; j < size; j++) columnStart[j + 1] = columnStart[j] + (j - firstRow[j] + 1);
+    values.assign(columnStart[size], 0);
+    factorized = false;
+}
+
+/**
+ * Adding a value to the entry (i, j)
+ * Entries of the lower triangle are mapped to the upper one
+ **/
+void TSkyline::add(size_t i, size_t j, double value) {
+    if (i > j) swap(i, j);
+    if (i < firstRow[j]) throw runtime_error("ERROR: Entry out of the skyline envelope.");
+    column(j)[i - firstRow[j]] += value;
+}
+
+double TSkyline::get(size_t i, size_t j) {
+    if (i > j) swap(i, j);
+    return (i < firstRow[j]) ? 0 : column(j)[i - firstRow[j]];
+}
+
+size_t TSkyline::getSize() {
+    return size;
+}
+
+size_t TSkyline::getProfileSize() {
+    return values.size();
+}
+
+/**
+ * In place Cholesky factorization K = Ut * U
+ * Left looking by columns:
+ * u(i, j) = (k(i, j) - sum(u(k, i) * u(k, j))) / u(i, i)
+ * u(j, j) = sqrt(k(j, j) - sum(u(k, j)^2))
+ * where the sums run over the rows shared by both column profiles.
+ *
+ * Columns are processed in blocks of BLOCK_SIZE. For the rows above a block,
+ * the outer loop goes row by row so the already factorized column i is read
+ * once from memory and reused for every column of the block.
+ **/
+void TSkyline::factorize() {
+    for (size_t j0 = 0; j0 < size; j0 += BLOCK_SIZE) {
+        size_t j1 = min(size, j0 + BLOCK_SIZE);
+        size_t r0 = j0;
+        for (size_t j = j0; j < j1; j++) r0 = min(r0, firstRow[j]);
+        
+        // Rows above the block
+        for (size_t i = r0; i < j0; i++) {
+            double *ci = column(i);
+            double uii = ci[i - firstRow[i]];
+            for (size_t j = j0; j < j1; j++) {
+                if (i < firstRow[j]) continue;
+                double *cj = column(j);
+                size_t k0 = max(firstRow[i], firstRow[j]);
+                cj[i - firstRow[j]] = (cj[i - firstRow[j]] - dot(ci + (k0 - firstRow[i]), cj + (k0 - firstRow[j]), i - k0)) / uii;
+            }
+        }
+        
+        // Rows inside the block and the diagonal
+        for (size_t j = j0; j < j1; j++) {
+            double *cj = column(j);
+            for (size_t i = max(j0, firstRow[j]); i < j; i++) {
+                double *ci = column(i);
+                size_t k0 = max(firstRow[i], firstRow[j]);
+                cj[i - firstRow[j]] = (cj[i - firstRow[j]] - dot(ci + (k0 - firstRow[i]), cj + (k0 - firstRow[j]), i - k0)) / ci[i - firstRow[i]];
+            }
+            double pivot = cj[j - firstRow[j]] - dot(cj, cj, j - firstRow[j]);
+            if (pivot <= 0) throw runtime_error("ERROR: Skyline matrix is not positive definite.");
+            cj[j - firstRow[j]] = sqrt(pivot);
+        }
+    }
+    factorized = true;
+}
+
+/**
+ * Solving K x = b with the factorized profile
+ * Forward substitution Ut y = b by columns (dot products)
+ * Backward substitution U x = y by columns (axpy updates)
+ **/
+void TSkyline::solve(gsl_vector *b, gsl_vector *x) {
+    if (!factorized) factorize();
+    vector<double> y(size);
+    for (size_t j = 0; j < size; j++) {
+        double *cj = column(j);
+        double sum = gsl_vector_get(b, j);
+        for (size_t k = firstRow[j]; k < j; k++) sum -= cj[k - firstRow[j]] * y[k];
+        y[j] = sum / cj[j - firstRow[j]];
+    }
+    for (size_t j = size; j-- > 0;) {
+        double *cj = column(j);
+        y[j] /= cj[j - firstRow[j]];
+        for (size_t k = firstRow[j]; k < j; k++) y[k] -= cj[k - firstRow[j]] * y[j];
+    }
+    for (size_t j = 0; j < size; j++) gsl_vector_set(x, j, y[j]);
+}
@@ -0,0 +1,62 @@
+//
+//  TSkyline.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSkyline_hpp
+#define TSkyline_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <stdexcept>
+
+#include <gsl/gsl_vector.h>
+
+/**
+ * Symmetric matrix stored by its skyline (variable band) profile
+ * Only the upper triangle is kept, column by column, from the first
+ * non zero row of the column down to the diagonal.
+ **/
+class TSkyline {
+    protected:
+        size_t size;
+        std::vector<size_t> firstRow;
+        std::vector<size_t> columnStart;
+        std::vector<double> values;
+        bool factorized;
+    
+        double * column(size_t j);
+    
+    public:
+        static const size_t BLOCK_SIZE = 64;
+    
+        TSkyline(size_t size);
+        virtual ~TSkyline();
+    
+        void addToEnvelope(size_t i, size_t j);
+        void allocate();
+        void add(size_t i, size_t j, double value);
+        double get(size_t i, size_t j);
+        size_t getSize();
+        size_t getProfileSize();
+        virtual void factorize();
+        virtual void solve(gsl_vector *b, gsl_vector *x);
+};
+
+#endif /* TSkyline_hpp */
@@ -0,0 +1,80 @@
+//
+//  TSkylineSolver.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSkylineSolver.hpp"
+
+#include "TSOrdering.hpp"
+
+using namespace std;
+
+TSkylineSolver::TSkylineSolver() : L(NULL), bandwidth(0) { }
+
+TSkylineSolver::~TSkylineSolver() {
+    delete L;
+}
+
+string TSkylineSolver::getName() {
+    return "skyline";
+}
+
+/**
+ * Renumbering and envelope of the renumbered K
+ **/
+void TSkylineSolver::analyze(TSparseMatrix *K) {
+    size = K->getSize();
+    vector<vector<size_t> > adjacency = K->getAdjacency();
+    order = TSOrdering::reverseCuthillMcKee(adjacency);
+    bandwidth = TSOrdering::getBandwidth(adjacency, order);
+    
+    delete L;
+    L = new TSkyline(size);
+    for (size_t i = 0; i < size; i++)
+        for (size_t k = 0; k < adjacency[i].size(); k++) L->addToEnvelope(order[i], order[adjacency[i][k]]);
+    L->allocate();
+}
+
+void TSkylineSolver::factorize(TSparseMatrix *K) {
+    L->allocate();
+    for (size_t i = 0; i < size; i++)
+        for (size_t p = K->getRowStart(i); p < K->getRowStart(i + 1); p++)
+            if (order[i] <= order[K->getColumn(p)]) L->add(order[i], order[K->getColumn(p)], K->getValue(p));
+    L->factorize();
+}
+
+/**
+ * Solving in the renumbered system
+ **/
+void TSkylineSolver::solve(gsl_vector *b, gsl_vector *x) {
+    gsl_vector *bo = gsl_vector_alloc(size);
+    gsl_vector *xo = gsl_vector_alloc(size);
+    for (size_t i = 0; i < size; i++) gsl_vector_set(bo, order[i], gsl_vector_get(b, i));
+    L->solve(bo, xo);
+    for (size_t i = 0; i < size; i++) gsl_vector_set(x, i, gsl_vector_get(xo, order[i]));
+    gsl_vector_free(bo); gsl_vector_free(xo);
+}
+
+size_t TSkylineSolver::getFactorSize() {
+    return L ? L->getProfileSize() : 0;
+}
+
+size_t TSkylineSolver::getBandwidth() {
+    return bandwidth;
+}
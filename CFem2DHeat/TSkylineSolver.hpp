@@ -0,0 +1,52 @@
+//
+//  TSkylineSolver.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSkylineSolver_hpp
+#define TSkylineSolver_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "TLinearSolver.hpp"
+#include "TSkyline.hpp"
+
+/**
+ * Skyline Cholesky on the Reverse Cuthill-McKee renumbered K
+ **/
+class TSkylineSolver : public TLinearSolver {
+    private:
+        TSkyline *L;
+        std::vector<size_t> order;
+        size_t bandwidth;
+    
+    public:
+        TSkylineSolver();
+        virtual ~TSkylineSolver();
+    
+        std::string getName();
+        void analyze(TSparseMatrix *K);
+        void factorize(TSparseMatrix *K);
+        void solve(gsl_vector *b, gsl_vector *x);
+        size_t getFactorSize();
+        size_t getBandwidth();
+};
+
+#endif /* TSkylineSolver_hpp */
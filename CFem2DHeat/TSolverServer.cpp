@@ -0,0 +1,227 @@
+//
+//  TSolverServer.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSolverServer.hpp"
+#include "TCommandLine.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <stdexcept>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+using namespace std;
+
+TSolverServer::TSolverServer(string socketPath) : socketPath(socketPath) { }
+
+TSolverServer::~TSolverServer() { }
+
+/**
+ * One socket per user in a directory only that user can write, so nobody
+ * else can take its place: $XDG_RUNTIME_DIR or /tmp/CFem2DHeat-<uid> (0700).
+ * Empty when that directory exists and is not a private one of the user.
+ **/
+string TSolverServer::getDefaultSocket() {
+    const char *runtime = getenv("XDG_RUNTIME_DIR");
+    if (runtime != NULL && runtime[0] == '/') return string(runtime) + "/CFem2DHeat.sock";
+    
+    string directory = "/tmp/CFem2DHeat-" + to_string(getuid());
+    mkdir(directory.c_str(), 0700);
+    struct stat status;
+    if (lstat(directory.c_str(), &status) != 0 || !S_ISDIR(status.st_mode) || status.st_uid != getuid() || (status.st_mode & 077) != 0) return "";
+    return directory + "/server.sock";
+}
+
+/**
+ * User id of the process on the other side of a connected socket
+ **/
+bool TSolverServer::getPeerUser(int socket, uid_t &user) {
+#ifdef __APPLE__
+    gid_t group;
+    return getpeereid(socket, &user, &group) == 0;
+#else
+    struct ucred credentials;
+    socklen_t size = sizeof(credentials);
+    if (getsockopt(socket, SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0) return false;
+    user = credentials.uid;
+    return true;
+#endif
+}
+
+/**
+ * A server of another user is never trusted with the job (nor its results),
+ * the client then solves in process
+ **/
+int TSolverServer::connectTo() {
+    sockaddr_un address;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) return -1;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client < 0) return -1;
+    uid_t user;
+    if (connect(client, (sockaddr *)&address, sizeof(address)) < 0 || !getPeerUser(client, user) || user != getuid()) {
+        close(client);
+        return -1;
+    }
+    return client;
+}
+
+bool TSolverServer::sendAll(int socket, string data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t amount = write(socket, data.data() + sent, data.size() - sent);
+        if (amount <= 0) return false;
+        sent += amount;
+    }
+    return true;
+}
+
+string TSolverServer::receiveAll(int socket) {
+    string data;
+    char buffer[65536];
+    ssize_t amount;
+    while ((amount = read(socket, buffer, sizeof(buffer))) > 0) data.append(buffer, amount);
+    return data;
+}
+
+/**
+ * Running one request as if it was a command line in the client directory
+ * Everything the job prints is captured for the client
+ **/
+string TSolverServer::runJob(string request, function<int(TModelCache *)> job, TModelCache &cache, bool &stop) {
+    vector<string> fields;
+    size_t first = 0, last;
+    while ((last = request.find('\0', first)) != string::npos) {
+        fields.push_back(request.substr(first, last - first));
+        first = last + 1;
+    }
+    if (fields.empty()) return "1\nERROR: Empty request.\n";
+    
+    vector<const char *> argv;
+    argv.push_back("CFem2DHeat");
+    for (size_t i = 1; i < fields.size(); i++) argv.push_back(fields[i].c_str());
+    TCommandLine::parse((int)argv.size(), argv.data());
+    
+    if (TCommandLine::hasOption("stop-server")) {
+        stop = true;
+        return "0\nServer stopped\n";
+    }
+    
+    int exitCode = 1;
+    ostringstream output;
+    streambuf *console = cout.rdbuf(output.rdbuf());
+    try {
+        if (chdir(fields[0].c_str()) != 0) throw runtime_error("ERROR: Cannot change to the directory " + fields[0] + ".");
+        exitCode = job(&cache);
+    } catch (exception &e) {
+        cout << e.what() << endl;
+    }
+    cout.rdbuf(console);
+    return to_string(exitCode) + "\n" + output.str();
+}
+
+int TSolverServer::serve(function<int(TModelCache *)> job, size_t cacheSize) {
+    sockaddr_un address;
+    if (socketPath.empty()) throw runtime_error("ERROR: No private directory for the socket, use --socket=<path>.");
+    if (socketPath.size() >= sizeof(address.sun_path)) throw runtime_error("ERROR: Socket path too long " + socketPath + ".");
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    
+    // A socket file left by a server that is not running anymore is replaced
+    int running = connectTo();
+    if (running >= 0) {
+        close(running);
+        throw runtime_error("ERROR: A server is already listening on " + socketPath + ".");
+    }
+    unlink(socketPath.c_str());
+    
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0 || ::bind(server, (sockaddr *)&address, sizeof(address)) < 0 || listen(server, 16) < 0) {
+        throw runtime_error("ERROR: Cannot listen on " + socketPath + ".");
+    }
+    signal(SIGPIPE, SIG_IGN); // a client going away only loses its own response
+    
+    unsigned int verbosityLevel = TCommandLine::getVerbosityLevel();
+    if (verbosityLevel >= 1) cout << "Serving on " << socketPath << endl;
+    
+    TModelCache cache(cacheSize);
+    bool stop = false;
+    while (!stop) {
+        // Only jobs of the same user, they run with its files and permissions
+        int client = accept(server, NULL, NULL);
+        if (client < 0) continue;
+        uid_t user;
+        if (!getPeerUser(client, user) || user != getuid()) {
+            close(client);
+            continue;
+        }
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        string request = receiveAll(client);
+        string response = runJob(request, job, cache, stop);
+        sendAll(client, response);
+        close(client);
+        
+        if (verbosityLevel >= 1) {
+            chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+            cout << "Job " << TCommandLine::getProblemName() << " exit code (" << response.substr(0, response.find('\n')) << ")";
+            cout << " time (" << elapsed.count() << "s) cached models (" << cache.getSize() << ")" << endl;
+        }
+    }
+    close(server);
+    unlink(socketPath.c_str());
+    return 0;
+}
+
+/**
+ * Sending the command line to the server, false when there is none listening
+ **/
+bool TSolverServer::forward(int argc, const char * argv[], int &exitCode) {
+    int client = connectTo();
+    if (client < 0) return false;
+    
+    char directory[4096];
+    string request = getcwd(directory, sizeof(directory)) ? directory : ".";
+    request.push_back('\0');
+    for (int i = 1; i < argc; i++) {
+        request += argv[i];
+        request.push_back('\0');
+    }
+    bool sent = sendAll(client, request);
+    shutdown(client, SHUT_WR);
+    string response = sent ? receiveAll(client) : "";
+    close(client);
+    
+    size_t newLine = response.find('\n');
+    if (newLine == string::npos) throw runtime_error("ERROR: No response from the server on " + socketPath + ".");
+    exitCode = atoi(response.substr(0, newLine).c_str());
+    cout << response.substr(newLine + 1) << flush;
+    return true;
+}
@@ -0,0 +1,67 @@
+//
+//  TSolverServer.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSolverServer_hpp
+#define TSolverServer_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <sys/types.h>
+
+#include "TModelCache.hpp"
+
+/**
+ * Persistent solver behind a local Unix domain socket
+ * CFem2DHeat --server [--socket=<path>] [--cache-size=<models>] keeps running
+ * and solves the jobs sent by the clients one after the other, the solved
+ * models stay in a TModelCache between them.
+ *
+ * Any other run is a thin client: when a server is listening the command
+ * line and the working directory are sent to it and its output and exit
+ * code are given back, otherwise the problem is solved in process as usual.
+ * So the GiD batch file works unchanged with or without a server.
+ * Both sides check that the other one runs as the same user.
+ *
+ * Request:  working directory and arguments, '\0' terminated
+ * Response: exit code line followed by the job output
+ **/
+class TSolverServer {
+    private:
+        std::string socketPath;
+    
+        int connectTo();
+        static bool getPeerUser(int socket, uid_t &user);
+        static bool sendAll(int socket, std::string data);
+        static std::string receiveAll(int socket);
+        std::string runJob(std::string request, std::function<int(TModelCache *)> job, TModelCache &cache, bool &stop);
+    
+    public:
+        TSolverServer(std::string socketPath);
+        virtual ~TSolverServer();
+    
+        static std::string getDefaultSocket();
+        int serve(std::function<int(TModelCache *)> job, size_t cacheSize);
+        bool forward(int argc, const char * argv[], int &exitCode);
+};
+
+#endif /* TSolverServer_hpp */
@@ -0,0 +1,195 @@
+//
+//  TSparseMatrix.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSparseMatrix.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+
+/**
+ * Building the pattern from the element nodes
+ **/
+TSparseMatrix::TSparseMatrix(map<size_t, TElement*> &connectivities, size_t size) : size(size) {
+    vector<vector<size_t> > rows(size);
+    map<size_t, TElement*>::iterator it;
+    for (it = connectivities.begin(); it != connectivities.end(); it++) {
+        vector<size_t> nodeIds = it->second->getNodeIds();
+        for (size_t j = 0; j < nodeIds.size(); j++)
+            for (size_t k = 0; k < nodeIds.size(); k++) rows[nodeIds[j] - 1].push_back(nodeIds[k] - 1);
+    }
+    setPattern(rows);
+}
+
+/**
+ * Pattern given by the columns of each row (both triangles, in any order)
+ **/
+TSparseMatrix::TSparseMatrix(vector<vector<size_t> > &rows) : size(rows.size()) {
+    setPattern(rows);
+}
+
+/**
+ * Every row is sorted so the entries can be found by bisection
+ * The rows are released while they are copied
+ **/
+void TSparseMatrix::setPattern(vector<vector<size_t> > &rows) {
+    rowStart.assign(size + 1, 0);
+    for (size_t i = 0; i < size; i++) {
+        rows[i].push_back(i); // the diagonal is always there
+        sort(rows[i].begin(), rows[i].end());
+        rows[i].erase(unique(rows[i].begin(), rows[i].end()), rows[i].end());
+        rowStart[i + 1] = rowStart[i] + rows[i].size();
+    }
+    
+    columns.reserve(rowStart[size]);
+    for (size_t i = 0; i < size; i++) {
+        columns.insert(columns.end(), rows[i].begin(), rows[i].end());
+        vector<size_t>().swap(rows[i]);
+    }
+    values.assign(columns.size(), 0);
+}
+
+TSparseMatrix::TSparseMatrix() : size(0) { }
+
+TSparseMatrix::~TSparseMatrix() { }
+
+void TSparseMatrix::add(size_t i, size_t j, double value) {
+    vector<size_t>::iterator first = columns.begin() + rowStart[i];
+    vector<size_t>::iterator last  = columns.begin() + rowStart[i + 1];
+    vector<size_t>::iterator found = lower_bound(first, last, j);
+    if (found == last || *found != j) throw runtime_error("ERROR: Entry out of the sparse matrix pattern.");
+    values[found - columns.begin()] += value;
+}
+
+double TSparseMatrix::get(size_t i, size_t j) {
+    vector<size_t>::iterator first = columns.begin() + rowStart[i];
+    vector<size_t>::iterator last  = columns.begin() + rowStart[i + 1];
+    vector<size_t>::iterator found = lower_bound(first, last, j);
+    return (found == last || *found != j) ? 0 : values[found - columns.begin()];
+}
+
+void TSparseMatrix::setAll(double value) {
+    fill(values.begin(), values.end(), value);
+}
+
+/**
+ * K += factor * other, both built from the same connectivities (same pattern)
+ **/
+void TSparseMatrix::addScaled(TSparseMatrix *other, double factor) {
+    if (other->size != size || other->values.size() != values.size()) throw runtime_error("ERROR: Sparse matrices with different patterns.");
+    for (size_t p = 0; p < values.size(); p++) values[p] += factor * other->values[p];
+}
+
+/**
+ * y = K * x
+ **/
+void TSparseMatrix::multiply(gsl_vector *x, gsl_vector *y) {
+    for (size_t i = 0; i < size; i++) {
+        double sum = 0;
+        for (size_t p = rowStart[i]; p < rowStart[i + 1]; p++) sum += values[p] * gsl_vector_get(x, columns[p]);
+        gsl_vector_set(y, i, sum);
+    }
+}
+
+size_t TSparseMatrix::getSize() {
+    return size;
+}
+
+size_t TSparseMatrix::getNonZeros() {
+    return values.size();
+}
+
+/**
+ * Row i is stored from getRowStart(i) to getRowStart(i + 1)
+ **/
+size_t TSparseMatrix::getRowStart(size_t i) {
+    return rowStart[i];
+}
+
+size_t TSparseMatrix::getColumn(size_t p) {
+    return columns[p];
+}
+
+double TSparseMatrix::getValue(size_t p) {
+    return values[p];
+}
+
+/**
+ * Node graph of the matrix (the pattern without the diagonal)
+ **/
+vector<vector<size_t> > TSparseMatrix::getAdjacency() {
+    vector<vector<size_t> > adjacency(size);
+    for (size_t i = 0; i < size; i++)
+        for (size_t p = rowStart[i]; p < rowStart[i + 1]; p++)
+            if (columns[p] != i) adjacency[i].push_back(columns[p]);
+    return adjacency;
+}
+
+/**
+ * K restricted to the rows and columns of the given nodes
+ * Local index i of the submatrix is the node nodes[i]
+ **/
+TSparseMatrix * TSparseMatrix::getSubmatrix(const vector<size_t> &nodes) {
+    const size_t NONE = (size_t)-1;
+    vector<size_t> local(size, NONE);
+    for (size_t i = 0; i < nodes.size(); i++) local[nodes[i]] = i;
+    
+    TSparseMatrix *sub = new TSparseMatrix();
+    sub->size = nodes.size();
+    sub->rowStart.assign(nodes.size() + 1, 0);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        vector<pair<size_t, double> > row;
+        for (size_t p = rowStart[nodes[i]]; p < rowStart[nodes[i] + 1]; p++)
+            if (local[columns[p]] != NONE) row.push_back(make_pair(local[columns[p]], values[p]));
+        sort(row.begin(), row.end());
+        for (size_t k = 0; k < row.size(); k++) {
+            sub->columns.push_back(row[k].first);
+            sub->values.push_back(row[k].second);
+        }
+        sub->rowStart[i + 1] = sub->columns.size();
+    }
+    return sub;
+}
+
+/**
+ * Full copy of the matrix just for printing purpose
+ **/
+gsl_matrix * TSparseMatrix::getDense() {
+    gsl_matrix *dense = gsl_matrix_alloc(size, size);
+    gsl_matrix_set_all(dense, 0);
+    for (size_t i = 0; i < size; i++)
+        for (size_t p = rowStart[i]; p < rowStart[i + 1]; p++) gsl_matrix_set(dense, i, columns[p], values[p]);
+    return dense;
+}
+
+/**
+ * Matrix Market coordinate file of the stored values (1 based)
+ **/
+void TSparseMatrix::saveMatrixMarket(string fileName) {
+    ofstream outFile(fileName.c_str());
+    if (!outFile.is_open()) throw runtime_error("ERROR: Cannot write the file " + fileName + ".");
+    outFile.precision(17);
+    outFile << "%%MatrixMarket matrix coordinate real general" << '\n';
+    outFile << size << " " << size << " " << values.size() << '\n';
+    for (size_t i = 0; i < size; i++)
+        for (size_t p = rowStart[i]; p < rowStart[i + 1]; p++) outFile << i + 1 << " " << columns[p] + 1 << " " << values[p] << '\n';
+}
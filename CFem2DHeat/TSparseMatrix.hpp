@@ -0,0 +1,72 @@
+//
+//  TSparseMatrix.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSparseMatrix_hpp
+#define TSparseMatrix_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <map>
+#include <stdexcept>
+
+#include <gsl/gsl_vector.h>
+#include <gsl/gsl_matrix.h>
+
+#include "TElement.hpp"
+
+/**
+ * Symmetric matrix in compressed sparse row (CSR) format
+ * Both triangles are stored so a row gives every neighbour of the node.
+ * The pattern comes from the connectivities: k(i, j) is a non zero
+ * when the nodes i and j share an element.
+ **/
+class TSparseMatrix {
+    private:
+        size_t size;
+        std::vector<size_t> rowStart;
+        std::vector<size_t> columns;
+        std::vector<double> values;
+    
+        TSparseMatrix();
+        void setPattern(std::vector<std::vector<size_t> > &rows);
+    
+    public:
+        TSparseMatrix(std::map<size_t, TElement*> &connectivities, size_t size);
+        TSparseMatrix(std::vector<std::vector<size_t> > &rows);
+        virtual ~TSparseMatrix();
+    
+        void add(size_t i, size_t j, double value);
+        double get(size_t i, size_t j);
+        void setAll(double value);
+        void addScaled(TSparseMatrix *other, double factor);
+        void multiply(gsl_vector *x, gsl_vector *y);
+        size_t getSize();
+        size_t getNonZeros();
+        size_t getRowStart(size_t i);
+        size_t getColumn(size_t p);
+        double getValue(size_t p);
+        std::vector<std::vector<size_t> > getAdjacency();
+        TSparseMatrix * getSubmatrix(const std::vector<size_t> &nodes);
+        gsl_matrix * getDense();
+        void saveMatrixMarket(std::string fileName);
+};
+
+#endif /* TSparseMatrix_hpp */
@@ -0,0 +1,127 @@
+//
+//  TSpatialGrid.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSpatialGrid.hpp"
+
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+
+using namespace std;
+
+TSpatialGrid::TSpatialGrid(map<size_t, SNode> &nodes, vector<vector<size_t> > &triangles) : nodes(nodes), triangles(triangles) {
+    SNode upper;
+    lower.x = lower.y = HUGE_VAL;
+    upper.x = upper.y = -HUGE_VAL;
+    map<size_t, SNode>::iterator it;
+    for (it = this->nodes.begin(); it != this->nodes.end(); it++) {
+        lower.x = min(lower.x, it->second.x); upper.x = max(upper.x, it->second.x);
+        lower.y = min(lower.y, it->second.y); upper.y = max(upper.y, it->second.y);
+    }
+    if (this->nodes.empty()) lower.x = lower.y = upper.x = upper.y = 0;
+    
+    // Square cells, about one triangle each
+    TScalar width = upper.x - lower.x, height = upper.y - lower.y;
+    cellSize = sqrt(max(width * height, (TScalar)DBL_MIN) / max(triangles.size(), (size_t)1));
+    if (cellSize <= 0 || !isfinite(cellSize)) cellSize = max(max(width, height), (TScalar)1);
+    columns = (size_t)(width / cellSize) + 1;
+    rows    = (size_t)(height / cellSize) + 1;
+    buckets.resize(columns * rows);
+    
+    for (size_t t = 0; t < this->triangles.size(); t++) {
+        vector<size_t> &triangle = this->triangles[t];
+        TScalar minX = HUGE_VAL, maxX = -HUGE_VAL, minY = HUGE_VAL, maxY = -HUGE_VAL;
+        for (size_t j = 0; j < triangle.size(); j++) {
+            SNode &node = this->nodes[triangle[j]];
+            minX = min(minX, node.x); maxX = max(maxX, node.x);
+            minY = min(minY, node.y); maxY = max(maxY, node.y);
+        }
+        for (size_t r = getRow(minY); r <= getRow(maxY); r++)
+            for (size_t c = getColumn(minX); c <= getColumn(maxX); c++) buckets[r * columns + c].push_back(t);
+    }
+}
+
+TSpatialGrid::~TSpatialGrid() { }
+
+size_t TSpatialGrid::getColumn(TScalar x) {
+    TScalar column = floor((x - lower.x) / cellSize);
+    return (column < 0) ? 0 : min((size_t)column, columns - 1);
+}
+
+size_t TSpatialGrid::getRow(TScalar y) {
+    TScalar row = floor((y - lower.y) / cellSize);
+    return (row < 0) ? 0 : min((size_t)row, rows - 1);
+}
+
+/**
+ * Triangle containing the point and its barycentric weights, false if it is outside the mesh
+ **/
+bool TSpatialGrid::locate(SNode point, size_t &triangle, TScalar weights[3]) {
+    vector<size_t> &bucket = buckets[getRow(point.y) * columns + getColumn(point.x)];
+    for (size_t b = 0; b < bucket.size(); b++) {
+        vector<size_t> &candidate = triangles[bucket[b]];
+        SNode &p0 = nodes[candidate[0]], &p1 = nodes[candidate[1]], &p2 = nodes[candidate[2]];
+        TScalar area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+        if (area == 0) continue;
+        weights[0] = ((p1.x - point.x) * (p2.y - point.y) - (p2.x - point.x) * (p1.y - point.y)) / area;
+        weights[1] = ((p2.x - point.x) * (p0.y - point.y) - (p0.x - point.x) * (p2.y - point.y)) / area;
+        weights[2] = 1 - weights[0] - weights[1];
+        if (weights[0] < -TOLERANCE || weights[1] < -TOLERANCE || weights[2] < -TOLERANCE) continue;
+        triangle = bucket[b];
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Closest node to the point, looking at rings of buckets around it
+ **/
+size_t TSpatialGrid::nearest(SNode point) {
+    size_t column = getColumn(point.x), row = getRow(point.y);
+    size_t best = 0;
+    TScalar bestDistance = HUGE_VAL;
+    for (size_t ring = 0; ring < max(columns, rows); ring++) {
+        // Nothing in this ring can be closer than ring - 1 cells
+        if (ring > 0 && bestDistance < (ring - 1) * cellSize) break;
+        for (size_t r = (row > ring ? row - ring : 0); r <= min(row + ring, rows - 1); r++) {
+            for (size_t c = (column > ring ? column - ring : 0); c <= min(column + ring, columns - 1); c++) {
+                if (max(r > row ? r - row : row - r, c > column ? c - column : column - c) != ring) continue;
+                vector<size_t> &bucket = buckets[r * columns + c];
+                for (size_t b = 0; b < bucket.size(); b++) {
+                    vector<size_t> &candidate = triangles[bucket[b]];
+                    for (size_t j = 0; j < candidate.size(); j++) {
+                        SNode &node = nodes[candidate[j]];
+                        TScalar distance = hypot(node.x - point.x, node.y - point.y);
+                        if (distance < bestDistance) {
+                            bestDistance = distance;
+                            best = candidate[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+vector<size_t> & TSpatialGrid::getTriangle(size_t triangle) {
+    return triangles[triangle];
+}
@@ -0,0 +1,62 @@
+//
+//  TSpatialGrid.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSpatialGrid_hpp
+#define TSpatialGrid_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <map>
+
+#include "TElement.hpp"
+
+/**
+ * Uniform grid of buckets over a triangle mesh
+ * Every triangle is in the buckets its bounding box touches, about one
+ * triangle per bucket, so finding the triangle that contains a point only
+ * checks the few triangles of its bucket.
+ * Nodes are given by id and the triangles by the ids of their nodes.
+ **/
+class TSpatialGrid {
+    private:
+        std::map<size_t, SNode> nodes;
+        std::vector<std::vector<size_t> > triangles;
+        std::vector<std::vector<size_t> > buckets;  // triangles of each bucket
+        SNode lower;
+        TScalar cellSize;
+        size_t columns;
+        size_t rows;
+    
+        size_t getColumn(TScalar x);
+        size_t getRow(TScalar y);
+    
+    public:
+        static constexpr double TOLERANCE = 1e-9;  // relative to the triangle area
+    
+        TSpatialGrid(std::map<size_t, SNode> &nodes, std::vector<std::vector<size_t> > &triangles);
+        virtual ~TSpatialGrid();
+    
+        bool locate(SNode point, size_t &triangle, TScalar weights[3]);
+        size_t nearest(SNode point);
+        std::vector<size_t> & getTriangle(size_t triangle);
+};
+
+#endif /* TSpatialGrid_hpp */
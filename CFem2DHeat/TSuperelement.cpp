@@ -0,0 +1,104 @@
+//
+//  TSuperelement.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TSuperelement.hpp"
+
+#include <math.h>
+
+using namespace std;
+
+/**
+ * Factorizing Kii and building C column by column: C(:, b) = Kib^t Kii^-1 Kib(:, b)
+ **/
+TSuperelement::TSuperelement(TSparseMatrix *Kii, gsl_matrix *Kib) : copies(1) {
+    amountOfInterior = Kii->getSize();
+    amountOfBoundary = Kib->size2;
+    diagonal.resize(amountOfInterior);
+    for (size_t i = 0; i < amountOfInterior; i++) diagonal[i] = Kii->get(i, i);
+    
+    interiorSolver = new TCholeskySolver<double>();
+    interiorSolver->analyze(Kii);
+    interiorSolver->factorize(Kii);
+    
+    correction = gsl_matrix_alloc(amountOfBoundary, amountOfBoundary);
+    gsl_vector *column = gsl_vector_alloc(amountOfInterior);
+    gsl_vector *y = gsl_vector_alloc(amountOfInterior);
+    for (size_t b = 0; b < amountOfBoundary; b++) {
+        gsl_matrix_get_col(column, Kib, b);
+        interiorSolver->solve(column, y);
+        for (size_t a = 0; a < amountOfBoundary; a++) {
+            double sum = 0;
+            for (size_t i = 0; i < amountOfInterior; i++) sum += gsl_matrix_get(Kib, i, a) * gsl_vector_get(y, i);
+            gsl_matrix_set(correction, a, b, sum);
+        }
+    }
+    gsl_vector_free(column);
+    gsl_vector_free(y);
+}
+
+TSuperelement::~TSuperelement() {
+    delete interiorSolver;
+    gsl_matrix_free(correction);
+}
+
+/**
+ * Cheap check that a copy found by its geometry really has the same Kii
+ * (the interior nodes of the copy are given in the order of this superelement)
+ * up to the relative tolerance that its geometry allows
+ **/
+bool TSuperelement::matches(TSparseMatrix *K, const vector<size_t> &interior, size_t amountOfBoundary, double tolerance) {
+    if (interior.size() != amountOfInterior || amountOfBoundary != this->amountOfBoundary) return false;
+    for (size_t i = 0; i < amountOfInterior; i++) {
+        if (fabs(K->get(interior[i], interior[i]) - diagonal[i]) > tolerance * fabs(diagonal[i])) return false;
+    }
+    return true;
+}
+
+void TSuperelement::addCopy() {
+    copies++;
+}
+
+/**
+ * x = Kii^-1 b
+ **/
+void TSuperelement::solveInterior(gsl_vector *b, gsl_vector *x) {
+    interiorSolver->solve(b, x);
+}
+
+double TSuperelement::getCorrection(size_t a, size_t b) {
+    return gsl_matrix_get(correction, a, b);
+}
+
+size_t TSuperelement::getAmountOfInterior() {
+    return amountOfInterior;
+}
+
+size_t TSuperelement::getAmountOfBoundary() {
+    return amountOfBoundary;
+}
+
+size_t TSuperelement::getCopies() {
+    return copies;
+}
+
+size_t TSuperelement::getFactorSize() {
+    return interiorSolver->getFactorSize() + amountOfBoundary * amountOfBoundary;
+}
@@ -0,0 +1,65 @@
+//
+//  TSuperelement.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TSuperelement_hpp
+#define TSuperelement_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include <gsl/gsl_vector.h>
+#include <gsl/gsl_matrix.h>
+
+#include "TSparseMatrix.hpp"
+#include "TCholeskySolver.hpp"
+
+/**
+ * Condensed substructure
+ * The interior nodes (i) are eliminated in favour of the boundary nodes (b):
+ * Kii is factorized once and C = Kbi Kii^-1 Kib is kept as a dense matrix,
+ * so the substructure adds Kbb - C to the global system.
+ * Every copy of the substructure shares the factor and C, its interior and
+ * boundary nodes are given in the same order as the ones used to build it.
+ **/
+class TSuperelement {
+    private:
+        size_t amountOfInterior;
+        size_t amountOfBoundary;
+        size_t copies;
+        std::vector<double> diagonal; // Kii diagonal, to check the copies
+        TCholeskySolver<double> *interiorSolver;
+        gsl_matrix *correction;
+    
+    public:
+        TSuperelement(TSparseMatrix *Kii, gsl_matrix *Kib);
+        virtual ~TSuperelement();
+    
+        bool matches(TSparseMatrix *K, const std::vector<size_t> &interior, size_t amountOfBoundary, double tolerance);
+        void addCopy();
+        void solveInterior(gsl_vector *b, gsl_vector *x);
+        double getCorrection(size_t a, size_t b);
+        size_t getAmountOfInterior();
+        size_t getAmountOfBoundary();
+        size_t getCopies();
+        size_t getFactorSize();
+};
+
+#endif /* TSuperelement_hpp */
@@ -0,0 +1,98 @@
+//
+//  TThreadPool.cpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TThreadPool.hpp"
+
+#include "TCommandLine.hpp"
+
+using namespace std;
+
+/**
+ * The calling thread is one of the threads, so threads - 1 workers are created
+ **/
+TThreadPool::TThreadPool(unsigned int threads) : next(0), count(0), busy(0), generation(0), stopping(false) {
+    for (unsigned int i = 1; i < threads; i++) workers.push_back(thread(&TThreadPool::work, this));
+}
+
+TThreadPool::~TThreadPool() {
+    {
+        unique_lock<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+unsigned int TThreadPool::getSize() {
+    return (unsigned int)workers.size() + 1;
+}
+
+/**
+ * Taking indexes until the loop is exhausted
+ **/
+void TThreadPool::run() {
+    for (size_t i = next++; i < count; i = next++) job(i);
+}
+
+void TThreadPool::work() {
+    size_t seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        run();
+        {
+            unique_lock<mutex> guard(lock);
+            if (--busy == 0) done.notify_all();
+        }
+    }
+}
+
+void TThreadPool::parallelFor(size_t count, function<void(size_t)> job) {
+    if (workers.empty() || count < 2) {
+        for (size_t i = 0; i < count; i++) job(i);
+        return;
+    }
+    {
+        unique_lock<mutex> guard(lock);
+        this->job   = job;
+        this->count = count;
+        next        = 0;
+        busy        = workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    run();
+    unique_lock<mutex> guard(lock);
+    done.wait(guard, [this] { return busy == 0; });
+}
+
+/**
+ * Amount of threads from --threads=N, the hardware concurrency by default
+ **/
+unsigned int TThreadPool::getDefaultThreads() {
+    unsigned int threads = (unsigned int)TCommandLine::getOption("threads", 0.0);
+    if (threads == 0) threads = thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
@@ -0,0 +1,66 @@
+//
+//  TThreadPool.hpp
+//  CFem2DHeat
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TThreadPool_hpp
+#define TThreadPool_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+/**
+ * Persistent worker threads for parallel loops
+ * parallelFor(count, job) runs job(0) ... job(count - 1) on the workers and
+ * the calling thread, taking indexes one by one, and returns when all of
+ * them are done. Workers sleep between loops so they can be reused by every
+ * iteration of a solver without paying the thread creation again.
+ **/
+class TThreadPool {
+    private:
+        std::vector<std::thread> workers;
+        std::mutex lock;
+        std::condition_variable wake;
+        std::condition_variable done;
+        std::function<void(size_t)> job;
+        std::atomic<size_t> next;
+        size_t count;
+        size_t busy;
+        size_t generation;
+        bool stopping;
+    
+        void work();
+        void run();
+    
+    public:
+        TThreadPool(unsigned int threads);
+        virtual ~TThreadPool();
+    
+        unsigned int getSize();
+        void parallelFor(size_t count, std::function<void(size_t)> job);
+    
+        static unsigned int getDefaultThreads();
+};
+
+#endif /* TThreadPool_hpp */
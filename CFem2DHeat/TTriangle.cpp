@@ -48,19 +48,19 @@ void TTriangle::calculateCentroid() {
     SDiff nDiff;
     nDiff.x     = n2.x - n1.x;
     nDiff.y     = n1.y - n2.y;
-    nDiff.hyp   = pow(pow(nDiff.x, 2) + pow(nDiff.y, 2), 0.5);
+    nDiff.hyp   = sqrt(nDiff.x * nDiff.x + nDiff.y * nDiff.y);
     diffs.push_back(nDiff);
     
     // From node 2 to node 3
     nDiff.x     = n3.x - n2.x;
     nDiff.y     = n2.y - n3.y;
-    nDiff.hyp   = pow(pow(nDiff.x, 2) + pow(nDiff.y, 2), 0.5);
+    nDiff.hyp   = sqrt(nDiff.x * nDiff.x + nDiff.y * nDiff.y);
     diffs.push_back(nDiff);
     
     // From node 3 to node 1
     nDiff.x     = n1.x - n3.x;
     nDiff.y     = n3.y - n1.y;
-    nDiff.hyp   = pow(pow(nDiff.x, 2) + pow(nDiff.y, 2), 0.5);
+    nDiff.hyp   = sqrt(nDiff.x * nDiff.x + nDiff.y * nDiff.y);
     diffs.push_back(nDiff);
     
     // Getting the center of the element
@@ -71,19 +71,19 @@ void TTriangle::calculateCentroid() {
     // From center to node 1
     nDiff.x     = center.x - n1.x;
     nDiff.y     = center.y - n1.y;
-    nDiff.hyp   = 0; //pow(pow(nDiff.x, 2) + pow(nDiff.y, 2), 0.5); We don't need this value so we avoid extra calcs
+    nDiff.hyp   = 0; //sqrt(nDiff.x * nDiff.x + nDiff.y * nDiff.y); We don't need this value so we avoid extra calcs
     centerDiffs.push_back(nDiff);
     
     // From center to node 2
     nDiff.x     = center.x - n2.x;
     nDiff.y     = center.y - n2.y;
-    nDiff.hyp   = 0; //pow(pow(nDiff.x, 2) + pow(nDiff.y, 2), 0.5); We don't need this value so we avoid extra calcs
+    nDiff.hyp   = 0; //sqrt(nDiff.x * nDiff.x + nDiff.y * nDiff.y); We don't need this value so we avoid extra calcs
     centerDiffs.push_back(nDiff);
     
     // From center to node 3
     nDiff.x     = center.x - n3.x;
     nDiff.y     = center.y - n3.y;
-    nDiff.hyp   = 0; //pow(pow(nDiff.x, 2) + pow(nDiff.y, 2), 0.5); We don't need this value so we avoid extra calcs
+    nDiff.hyp   = 0; //sqrt(nDiff.x * nDiff.x + nDiff.y * nDiff.y); We don't need this value so we avoid extra calcs
     centerDiffs.push_back(nDiff);
 }
 
@@ -119,87 +119,24 @@ void TTriangle::setBC() {
     c.push_back(diffs[1].x); c.push_back(diffs[2].x); c.push_back(diffs[0].x);
 }
 
-/**
- * It returns the edge index from element nodes i j
- * Edge 1 from Node 1 to Node 2 | [0] = [0, 1]
- * Edge 2 from Node 2 to Node 3 | [1] = [1, 2] || [2, 1]
- * Edge 3 from Node 3 to Node 1 | [2] = [0, 2]
- **/
-size_t TTriangle::getEdgeIndex(size_t i, size_t j) {
-    if ((i == 0) && (j == 1)) return 0;
-    if ((i == 0) && (j == 2)) return 2;
-    return 1;
-}
-
 /**
  * To get the kd matrix
  * We calculate the k element as alpha * (Bt * B)
  * where alpha is conductivity / (4 * area)
  **/
-gsl_matrix * TTriangle::getKd(long double conductivity) {
+gsl_matrix * TTriangle::getKd(TScalar conductivity) {
     gsl_matrix *kd = gsl_matrix_alloc(3, 3); //k element convection
     gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, conductivity / (4 * area), Bt, B, 0, kd);
     return kd;
 }
 
-/**
- * This method return the contribution of the convection boundary condition
- * for the K matrix element. The shape of the matrix is related with the nodes
- * involved in the boundary condition.
- * So for each nodes convination we have:
- * edge == 1   edge == 2   edge == 3
- * | 2 1 0 |   | 0 0 0 |   | 2 0 1 |
- * | 1 2 0 |   | 0 2 1 |   | 0 0 0 |
- * | 0 0 0 |   | 0 1 2 |   | 1 0 2 |
- * The contribution is determined scaling the matrix km by the convectivity factor:
- * (convectivity * L) / 6.0
- * where L is the edge length
- **/
-gsl_matrix * TTriangle::getKm(long double convectivity) {
-    gsl_matrix *km = gsl_matrix_alloc(3, 3); //k element convection
-    gsl_matrix_set_all(km, 0);
-    size_t i = -1, j = -1; size_t c = 0;
-    map<size_t, SCondition>::iterator it;
-    for (it = conditions.begin(); it != conditions.end(); it++) {
-        if (it->second.type == "Convection") {
-            if (i == -1) i = c; else j = c;
-        }
-        c++;
-    }
-    if (i != -1 && j != -1) {
-        size_t k = getEdgeIndex(i, j);
-        
-        if (k == 0) {
-            gsl_matrix_set(km, 0, 0, 2); gsl_matrix_set(km, 0, 1, 1); gsl_matrix_set(km, 0, 2, 0);
-            gsl_matrix_set(km, 1, 0, 1); gsl_matrix_set(km, 1, 1, 2); gsl_matrix_set(km, 1, 2, 0);
-            gsl_matrix_set(km, 2, 0, 0); gsl_matrix_set(km, 2, 1, 0); gsl_matrix_set(km, 2, 2, 0);
-        }
-
-        if (k == 1) {
-            gsl_matrix_set(km, 0, 0, 0); gsl_matrix_set(km, 0, 1, 0); gsl_matrix_set(km, 0, 2, 0);
-            gsl_matrix_set(km, 1, 0, 0); gsl_matrix_set(km, 1, 1, 2); gsl_matrix_set(km, 1, 2, 1);
-            gsl_matrix_set(km, 2, 0, 0); gsl_matrix_set(km, 2, 1, 1); gsl_matrix_set(km, 2, 2, 2);
-        }
-        
-        if (k == 2) {
-            gsl_matrix_set(km, 0, 0, 2); gsl_matrix_set(km, 0, 1, 0); gsl_matrix_set(km, 0, 2, 1);
-            gsl_matrix_set(km, 1, 0, 0); gsl_matrix_set(km, 1, 1, 0); gsl_matrix_set(km, 1, 2, 0);
-            gsl_matrix_set(km, 2, 0, 1); gsl_matrix_set(km, 2, 1, 0); gsl_matrix_set(km, 2, 2, 2);
-        }
-        
-        gsl_matrix_scale(km, (convectivity * getEdgeLength(k)) / 6.0);
-    }
-    
-    return km;
-}
-
 /**
  * Get the f element contribution for the fixed temperature
  * boundary condition
  **/
 gsl_vector * TTriangle::getF() {
     size_t c = 0;
-    f = gsl_vector_alloc(3); gsl_vector_set_all(f, 0);
+    gsl_vector_free(f); f = gsl_vector_alloc(3); gsl_vector_set_all(f, 0);
     map<size_t, SCondition>::iterator it;
     for (it = conditions.begin(); it != conditions.end(); it++) {
         if (it->second.type == "Temperature") {
@@ -209,64 +146,3 @@ gsl_vector * TTriangle::getF() {
     }
     return f;
 }
-
-/**
- * Calculate the f element convectivity boundary condition contribution
- * Same as the km matrix it is determined by a pair of node so:
- * edge == 1   edge == 2   edge == 3
- * | 1 |       | 0 |       | 1 |
- * | 1 |       | 1 |       | 0 |
- * | 0 |       | 1 |       | 1 |
- * The contribution is calculated scaling the vector f by:
- * (convectivity * Ta * L) / 2
- * where Ta is the ambient temperature
- * and L is the edge length
- **/
-gsl_vector * TTriangle::getFConvection(long double convectivity) {
-    fc = gsl_vector_alloc(3); gsl_vector_set_all(fc, 0);
-    size_t i = -1, j = -1; size_t c = 0;
-    map<size_t, SCondition>::iterator it;
-    for (it = conditions.begin(); it != conditions.end(); it++) {
-        if (it->second.type == "Convection") {
-            if (i == -1) i = c; else j = c;
-            gsl_vector_set(fc, c, convectivity * it->second.ambient);
-        }
-        c++;
-    }
-    if (i != -1 && j != -1) {
-        gsl_vector_scale(fc, getEdgeLength(getEdgeIndex(i, j)) / 2);
-    } else {
-        gsl_vector_set_all(fc, 0);
-    }
-    return fc;
-}
-
-/**
- * Calculate the f element flux boundary condition contribution
- * It is also determined by a pair of node so:
- * edge == 1   edge == 2   edge == 3
- * | 1 |       | 0 |       | 1 |
- * | 1 |       | 1 |       | 0 |
- * | 0 |       | 1 |       | 1 |
- * The contribution is calculated scaling the vector f by:
- * (flux * L) / 2
- * where L is the edge length
- **/
-gsl_vector * TTriangle::getFFlux(long double convectivity) {
-    ff = gsl_vector_alloc(3); gsl_vector_set_all(ff, 0);
-    size_t i = -1, j = -1; size_t c = 0;
-    map<size_t, SCondition>::iterator it;
-    for (it = conditions.begin(); it != conditions.end(); it++) {
-        if (it->second.type == "Flux") {
-            if (i == -1) i = c; else j = c;
-            gsl_vector_set(ff, c, it->second.flux);
-        }
-        c++;
-    }
-    if (i != -1 && j != -1) {
-        gsl_vector_scale(ff, getEdgeLength(getEdgeIndex(i, j)) / 2);
-    } else {
-        gsl_vector_set_all(ff, 0);
-    }
-    return ff;
-}
@@ -29,8 +29,8 @@
 
 class TTriangle : public TElement {
     private:
-        std::vector<long double> b;
-        std::vector<long double> c;
+        std::vector<TScalar> b;
+        std::vector<TScalar> c;
         void calculateCentroid();
         void calculateArea();
         void calculateB();
@@ -40,12 +40,8 @@ class TTriangle : public TElement {
         TTriangle();
         virtual ~TTriangle();
     
-        size_t getEdgeIndex(size_t i, size_t j);
-        gsl_matrix * getKd(long double conductivity);
-        gsl_matrix * getKm(long double convectivity);
+        gsl_matrix * getKd(TScalar conductivity);
         gsl_vector * getF();
-        gsl_vector * getFConvection(long double convectivity);
-        gsl_vector * getFFlux(long double convectivity);
 };
 
 #endif /* TTriangle_hpp */
@@ -0,0 +1,50 @@
+#!/bin/sh
+#
+#  run.sh
+#  CFem2DHeat
+#
+#  Regression run of the bundled examples: bin/tests/run.sh [<CFem2DHeat binary>]
+#  Every example is solved with each line of options below and its
+#  temperatures are compared with the bundled .post.res (relative 1e-6).
+#  The exit code is the amount of failed runs.
+#
+
+TESTS=$(cd "$(dirname "$0")" && pwd)
+BIN=${1:-"$TESTS/../CFem2DHeat"}
+case "$BIN" in /*) ;; *) BIN="$(pwd)/$BIN" ;; esac
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+temperatures() {
+    awk '/^Result "Temperature"/ { t = 1; next } t && /^End values/ { exit } t && $1 ~ /^[0-9]+$/ { print $1, $2 }' "$1"
+}
+
+FAILED=0
+for EXAMPLE in test_convection test_flux; do
+    while read -r OPTIONS; do
+        cp "$TESTS/$EXAMPLE.dat" "$WORK/"
+        rm -f "$WORK/$EXAMPLE.post.res"
+        if (cd "$WORK" && "$BIN" "$EXAMPLE" --no-server --no-cache $OPTIONS > /dev/null 2>&1); then
+            temperatures "$WORK/$EXAMPLE.post.res" > "$WORK/result"
+            temperatures "$TESTS/$EXAMPLE.post.res" > "$WORK/reference"
+            if paste -d ' ' "$WORK/result" "$WORK/reference" | awk '
+                { d = $2 - $4; if (d < 0) d = -d; m = $4 < 0 ? -$4 : $4; if ($1 != $3 || d > 1e-6 * (m > 1 ? m : 1)) bad = 1; n++ }
+                END { exit (bad || n == 0) }' && [ -s "$WORK/result" ] && [ "$(wc -l < "$WORK/result")" -eq "$(wc -l < "$WORK/reference")" ]; then
+                echo "OK     $EXAMPLE $OPTIONS"
+                continue
+            fi
+        fi
+        echo "FAILED $EXAMPLE $OPTIONS"
+        FAILED=$((FAILED + 1))
+    done <<EOF
+--solver=auto
+--solver=cholesky
+--solver=pcg-ic0
+--solver=schwarz
+--solver=schwarz --threads=32
+--solver=schwarz --subdomains=9
+--solver=schwarz --reproducible
+--solver=schwarz --reproducible --threads=32
+EOF
+done
+exit $FAILED
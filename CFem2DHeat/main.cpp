@@ -21,47 +21,400 @@
 
 #include <iostream>
 
+#include "TBatch.hpp"
+#include "TCheckpoint.hpp"
+#include "TCommandLine.hpp"
+#include "TCondensation.hpp"
+#include "TFileWatcher.hpp"
+#include "TInitialGuess.hpp"
+#include "TMemoryPlanner.hpp"
+#include "TProbes.hpp"
+#include "TRaster.hpp"
+#include "TReducedModel.hpp"
+#include "TSensitivity.hpp"
+#include "TPipeline.hpp"
+#include "TOutOfCoreSolver.hpp"
 #include "TInputParser.hpp"
+#include "TLinearSolver.hpp"
+#include "TModelCache.hpp"
+#include "TResultCache.hpp"
+#include "TSAssembly.hpp"
+#include "TSolverServer.hpp"
 #include "TSGsl.hpp"
+#include "TSLog.hpp"
+#include "TSMetrics.hpp"
+#include "TSReduction.hpp"
 
 using namespace std;
 
+static int analyze(TModelCache *cache);
+static int reduce();
+static void saveMetrics();
+
 int main(int argc, const char * argv[]) {
-    const map<string, unsigned int> verbosity = {{"-v", 1}, {"-vv", 2}, {"-vvv", 3}};
-    string fileName = argv[1] ? (string)argv[1] + ".dat" : "";
-    string verbose = argv[2] ? (string)argv[2] : "";
+    TCommandLine::parse(argc, argv);
+    
+    int exitCode = 0;
+    
+    /**
+     * Batch mode (--batch=<manifest or directory>), every problem in its own process
+     * The summary is also saved next to the batch as <batch>.summary
+     **/
+    if (TCommandLine::hasOption("batch")) {
+        string batchPath = TCommandLine::getOption("batch", "");
+        TBatch batch(argv[0], batchPath);
+        exitCode = batch.run();
+        batch.printSummary(cout);
+        while (batchPath.size() > 1 && batchPath.back() == '/') batchPath.erase(batchPath.size() - 1);
+        ofstream summary((batchPath + ".summary").c_str());
+        batch.printSummary(summary);
+        return exitCode;
+    }
+    
+    /**
+     * Watch mode (--watch), solving again every time the input file is written
+     * The model stays cached between runs so changing only boundary values
+     * reuses K and its factorization and starts from the last temperatures
+     **/
+    if (TCommandLine::hasOption("watch")) {
+        string fileName = TCommandLine::getProblemName() + ".dat";
+        TModelCache cache(1);
+        TFileWatcher watcher(fileName);
+        while (true) {
+            try {
+                analyze(&cache);
+            } catch (exception &e) {
+                cout << e.what() << endl;
+            }
+            cout << "Watching " << fileName << " for changes..." << endl;
+            if (!watcher.wait()) throw runtime_error("ERROR: Cannot watch the input file.");
+        }
+    }
     
-    unsigned int verbosityLevel = verbosity.find(verbose) != verbosity.end()
-        ? verbosity.at(verbose)
-        : 0;
+    /**
+     * Reduced order model: training (--rom-train=<samples>) or queries
+     * (--rom[=<model>] --rom-query=<queries>), see reduce
+     **/
+    if (TCommandLine::hasOption("rom-train") || TCommandLine::hasOption("rom")) return reduce();
+    
+    /**
+     * Server mode (--server) or the client of a running server, see TSolverServer
+     * Without a server listening the problem is solved here (also with --no-server)
+     **/
+    TSolverServer server(TCommandLine::getOption("socket", TSolverServer::getDefaultSocket()));
+    if (TCommandLine::hasOption("server")) return server.serve(analyze, (size_t)TCommandLine::getOption("cache-size", 4.0));
+    if (!TCommandLine::hasOption("no-server") && server.forward(argc, argv, exitCode)) return exitCode;
+    if (TCommandLine::hasOption("stop-server")) {
+        cout << "No server listening on " << TCommandLine::getOption("socket", TSolverServer::getDefaultSocket()) << endl;
+        return 1;
+    }
+    
+    return analyze(NULL);
+}
+
+/**
+ * Instrumentation of the run (--metrics[=<file>]), <name>.metrics.json by default
+ **/
+static void saveMetrics() {
+    if (!TSMetrics::isEnabled()) return;
+    string metricsName = TCommandLine::getOption("metrics", "");
+    if (metricsName.empty()) metricsName = TCommandLine::getProblemName() + ".metrics.json";
+    TSMetrics::writeJson(metricsName, TCommandLine::getProblemName());
+}
 
-    if ( verbosityLevel >= 1) {
-        cout << "Loading problem solver..." << endl;
-        cout << "Reading input file: " << fileName << endl << endl;
+/**
+ * Solving the problem given in the command line
+ * The cache is only given in server mode, it keeps the solved models between jobs
+ **/
+static int analyze(TModelCache *cache) {
+    string fileName = TCommandLine::getProblemName() + ".dat";
+    unsigned int verbosityLevel = TCommandLine::getVerbosityLevel();
+    
+    TSMetrics::enable(TCommandLine::hasOption("metrics"));
+    TSMetrics::track(TCommandLine::hasOption("metrics") || TCommandLine::hasOption("max-memory"));
+    TSMetrics::reset();
+    
+    // Sums of the solvers in a fixed order, the same result for any --threads (see TSReduction)
+    TSReduction::setReproducible(TCommandLine::hasOption("reproducible"));
+    
+    /**
+     * The diagnostics are written by the log thread (see TSLog)
+     * Every exit of this function waits for them so the console keeps its order
+     **/
+    TSLog::configure(verbosityLevel);
+    struct SLogFlush { ~SLogFlush() { TSLog::flush(); } } logFlush;
+
+    TLogLine(TSLog::INFO, TSLog::GENERAL) << "Loading problem solver..." << endl << "Reading input file: " << fileName << endl << endl;
+    
+    /**
+     * The run is a pipeline of stages, the ones that can overlap run on their own thread:
+     * parse -> assemble    elements are assembled while the rest of the file is read
+     * flux -> write        the Temperature block is written while the flux is estimated
+     **/
+    const size_t ELEMENT_BATCH_SIZE = 512;  // elements handed over at once
+    const size_t ELEMENT_QUEUE_SIZE = 16;   // batches in flight
+    const size_t FLUX_CHUNK_SIZE    = 4096; // nodes written at once
+    const size_t FLUX_QUEUE_SIZE    = 256;  // chunks in flight
+    TPipeline pipeline;
+    
+    /**
+     * Out of core runs (--out-of-core, --memory-budget=<MB>)
+     * The elements are released once assembled, K is spilled to disk every
+     * time its assembly buffer reaches the memory budget and the solver
+     * streams it from there. The flux stage reads the elements again.
+     **/
+    bool outOfCore = TCommandLine::hasOption("out-of-core") || TCommandLine::hasOption("memory-budget");
+    size_t memoryBudget = (size_t)(TCommandLine::getOption("memory-budget", 256.0) * 1024 * 1024);
+    TDiskMatrix *diskK = NULL;
+    
+    /**
+     * Memory planning from the amounts of the input file (--max-memory=<MB>)
+     * The estimates of every solver are printed with -v. An in core run
+     * gives the automatic solver what is left after the elements and K
+     * (pcg-jacobi when the selection itself does not fit), when not even
+     * a conjugate gradient fits the run goes out of core
+     * (with a smaller budget if needed) and if that does not fit it is refused.
+     * A solver given with --solver is refused when it does not fit.
+     **/
+    const double MB = 1024 * 1024;
+    size_t plannedElements = 0, plannedNodes = 0;
+    TMemoryPlanner *planner = NULL;
+    TLinearSolver::setMemoryLimit(0);
+    if (TMemoryPlanner::readAmounts(fileName, plannedElements, plannedNodes)) {
+        planner = new TMemoryPlanner(plannedNodes, plannedElements);
+        if (verbosityLevel >= 1) {
+            TLogLine line(TSLog::INFO, TSLog::GENERAL);
+            line << "Memory estimates in MB (" << plannedNodes << " nodes, " << planner->getNonZeros() << " non zeros):";
+            vector<string> solvers = planner->getSolvers();
+            for (size_t s = 0; s < solvers.size(); s++) line << " " << solvers[s] << " (" << planner->estimate(solvers[s]) / MB << ")";
+            line << " auto (" << planner->estimate("auto") / MB << ") out-of-core (" << planner->estimateOutOfCore(memoryBudget) / MB << ")" << endl;
+        }
+    }
+    if (planner != NULL && TCommandLine::hasOption("max-memory")) {
+        size_t maxMemory = (size_t)(TCommandLine::getOption("max-memory", 0.0) * MB);
+        string solverName = TCommandLine::getOption("solver", "auto");
+        if (!outOfCore && solverName != "auto" && planner->estimate(solverName) > maxMemory) {
+            size_t needed = planner->estimate(solverName);
+            delete planner;
+            throw runtime_error("ERROR: The " + solverName + " solver needs about " + to_string((size_t)(needed / MB)) + " MB, more than --max-memory.");
+        }
+        if (!outOfCore && solverName == "auto" && planner->getSolverLimit(maxMemory) > 0) {
+            TLinearSolver::setMemoryLimit(planner->getSolverLimit(maxMemory));
+            TLogLine(TSLog::INFO, TSLog::GENERAL) << "Planned in core, up to " << planner->getSolverLimit(maxMemory) / MB << " MB for the solver" << endl;
+        } else if (!outOfCore && solverName == "auto" && planner->estimate("pcg-jacobi") <= maxMemory) {
+            TCommandLine::setOption("solver", "pcg-jacobi");
+            TLogLine(TSLog::INFO, TSLog::GENERAL) << "Planned in core with pcg-jacobi, no room for the automatic selection" << endl;
+        } else if (outOfCore || solverName == "auto") {
+            if (planner->estimateOutOfCore(memoryBudget) > maxMemory) memoryBudget = planner->getOutOfCoreBudget(maxMemory);
+            if (memoryBudget == 0) {
+                size_t needed = planner->estimateOutOfCore(0);
+                delete planner;
+                throw runtime_error("ERROR: The problem needs at least " + to_string((size_t)(needed / MB)) + " MB out of core, more than --max-memory.");
+            }
+            outOfCore = true;
+            TLogLine(TSLog::INFO, TSLog::GENERAL) << "Planned out of core, memory budget " << memoryBudget / MB << " MB" << endl;
+        }
+    }
+    
+    /**
+     * Initial guess of the iterative solvers from a previous run (--initial-guess=<file>.post.res)
+     * Its files are read before the input file
+     **/
+    TInitialGuess *guess = NULL;
+    if (TCommandLine::hasOption("initial-guess")) guess = new TInitialGuess(TCommandLine::getOption("initial-guess", ""));
+    
+    /**
+     * Temperature and flux at the points of --probes=<file>, saved as <name>.probes
+     * (a cached result has none of these outputs so the result cache is skipped)
+     **/
+    TProbes *probes = NULL;
+    if (TCommandLine::hasOption("probes")) probes = new TProbes(TCommandLine::getOption("probes", ""));
+    
+    /**
+     * Temperature and flux magnitude on a regular grid (--raster=<columns>x<rows>,
+     * --raster-format=npy|raw), saved as <name>.T.npy and <name>.flux.npy
+     **/
+    TRaster *raster = NULL;
+    if (TCommandLine::hasOption("raster")) raster = new TRaster(TCommandLine::getOption("raster", ""), TCommandLine::getOption("raster-format", "npy"));
+    
+    /**
+     * Adjoint sensitivities of a functional (--functional=nodes:<id>,... or
+     * region:<x0>,<y0>,<x1>,<y1>), saved as <name>.sensitivity
+     **/
+    TSensitivity *sensitivity = NULL;
+    if (TCommandLine::hasOption("functional")) sensitivity = new TSensitivity(TCommandLine::getOption("functional", ""));
+    
+    TInputParser::setKeepElements(!outOfCore);
+    TInputParser::reset();
+    
+    /**
+     * Result cache (--cache-dir=<path>, unless --no-cache)
+     * A problem already solved with the same options gets its stored result
+     **/
+    TResultCache *results = NULL;
+    size_t resultKey = 0;
+    if (TCommandLine::hasOption("cache-dir") && !TCommandLine::hasOption("no-cache") && probes == NULL && raster == NULL && sensitivity == NULL) {
+        size_t limit = (size_t)(TCommandLine::getOption("cache-limit", (double)TResultCache::DEFAULT_LIMIT_MB) * 1024 * 1024);
+        results = new TResultCache(TCommandLine::getOption("cache-dir", ""), limit);
+    }
+    
+    /**
+     * Server mode: a quick read without the geometry gives the model key, when
+     * that model is cached its K, factorization and elements are reused and
+     * only its boundary elements are assembled again (into F)
+     * The same read gives the result key
+     **/
+    size_t modelKey = 0;
+    SCachedModel *model = NULL;
+    if ((cache != NULL && !outOfCore) || results != NULL) {
+        TScopedTimer timer("lookup");
+        TInputParser::setReadGeometry(false);
+        TInputParser::readFile(fileName);
+        TInputParser::setReadGeometry(true);
+        if (results != NULL && TInputParser::getStatus() == TInputParser::SUCCESS) {
+            resultKey = TResultCache::getKey(TInputParser::getSectionHashes());
+            string resultName = TCommandLine::getProblemName() + ".post.res";
+            bool hit = results->fetch(resultKey, resultName);
+            TSMetrics::set("resultCacheHits", hit ? 1 : 0);
+            if (hit) {
+                TLogLine(TSLog::INFO, TSLog::GENERAL) << "Result found in the cache, saving result: " << resultName << endl;
+                delete results;
+                delete guess;
+                delete planner;
+                saveMetrics();
+                return 0;
+            }
+        }
+        if (cache != NULL && !outOfCore) {
+            modelKey = TModelCache::getKey(TInputParser::getModelHash());
+            model = cache->find(modelKey);
+            TSMetrics::set("modelCacheHits", model != NULL ? 1 : 0);
+            // The section hashes are kept on every job, so the next -v one compares with this one
+            vector<unsigned int> changed = cache->getChangedSections(TInputParser::getSectionHashes());
+            if (verbosityLevel >= 1) {
+                TLogLine line(TSLog::INFO, TSLog::GENERAL);
+                line << "Changed sections (";
+                for (size_t c = 0; c < changed.size(); c++) line << (c ? ", " : "") << TInputParser::getSectionName(changed[c]);
+                line << ")" << endl;
+            }
+            if (model != NULL) TLogLine(TSLog::INFO, TSLog::GENERAL) << "Using cached model (" << model->hits << " hits)" << endl << endl;
+        }
+        if (model == NULL) TInputParser::reset();
     }
     
     /**
      * Reading GID pre processing file
      * Loading everything in memory so take care when the input file is too large
-     * TODO: Improve reading input file method.
+     * (or use the out of core mode)
+     * Every element is handed to the assembling stage as soon as it is read
      **/
-    TInputParser::readFile(fileName);
-    if (TInputParser::getStatus() == TInputParser::FAIL) {
-        throw runtime_error("ERROR: Cannot open the input file.");
-    }
+    TBoundedQueue<vector<pair<size_t, TElement*> > > elementQueue(ELEMENT_QUEUE_SIZE);
+    pipeline.async("parse", [&](SStage &stage) {
+        vector<pair<size_t, TElement*> > batch;
+        if (model != NULL) {
+            // The cached boundary elements with the new values of their conditions
+            map<size_t, SCondition> current = TInputParser::getConditions();
+            SCondition OCondition; OCondition.type = "unset";
+            for (size_t b = 0; b < model->boundary.size(); b++) {
+                TElement *OElement = model->boundary[b].second;
+                map<size_t, SCondition> elmConditions;
+                vector<size_t> nodeIds = OElement->getNodeIds();
+                for (size_t j = 0; j < nodeIds.size(); j++)
+                    elmConditions[nodeIds[j]] = (current.find(nodeIds[j]) != current.end()) ? current[nodeIds[j]] : OCondition;
+                OElement->setConditions(elmConditions);
+            }
+            elementQueue.push(model->boundary, stage.stall);
+            elementQueue.close();
+            return;
+        }
+        TInputParser::setElementHook([&](size_t id, TElement *OElement) {
+            batch.push_back(make_pair(id, OElement));
+            if (batch.size() < ELEMENT_BATCH_SIZE) return;
+            elementQueue.push(batch, stage.stall);
+            batch.clear();
+        });
+        try {
+            TInputParser::readFile(fileName);
+            if (!batch.empty()) elementQueue.push(batch, stage.stall);
+        } catch (...) {
+            elementQueue.close();
+            throw;
+        }
+        elementQueue.close();
+    });
+    
+    /**
+     * Getting information of the Input static object
+     * Everything but the connectivities is read before the first element arrives
+     **/
+    size_t amountOfNodes = 0;
+    size_t amountOfElements = 0;
+    map<size_t, SCondition> conditions;
+    map<size_t, SMaterial> materials;
+    gsl_vector *F = NULL;
+    auto loadProblem = [&]() {
+        amountOfNodes       = TInputParser::getAmountOfNodes();
+        amountOfElements    = TInputParser::getAmountOfElements();
+        conditions          = TInputParser::getConditions();
+        materials           = TInputParser::getMaterials();
+        F = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(F, 0);
+        if (outOfCore) diskK = new TDiskMatrix(TCommandLine::getProblemName() + ".ooc", amountOfNodes, memoryBudget);
+        
+        /**
+         * Printing problem dimension
+         * Number of Nodes
+         * Number of elements
+         **/
+        TLogLine(TSLog::INFO, TSLog::GENERAL) << "Problem dimension:" << endl
+                                              << "Number of nodes (" << amountOfNodes << ")" << endl
+                                              << "Number of elements (" << amountOfElements << ")" << endl << endl
+                                              << "Assembling matrixs..." << endl;
+    };
     
     /**
-     * Printing problem dimension
-     * Number of Nodes
-     * Number of elements
+     * For each element in the problem we calculate k and f
+     * The pattern of K needs every connectivity so the k values are kept as
+     * (row, column, value) entries until the file is read (or spilled to
+     * disk when out of core), f goes straight to F
      **/
-    size_t amountOfNodes    = TInputParser::getAmountOfNodes();
-    size_t amountOfElements = TInputParser::getAmountOfElements();
-    if ( verbosityLevel >= 1) {
-        cout << "Problem dimension:" << endl;
-        cout << "Number of nodes (" << amountOfNodes << ")" << endl;
-        cout << "Number of elements (" << amountOfElements << ")" << endl << endl;
+    vector<size_t> entryRows, entryColumns;
+    vector<double> entryValues;
+    auto addEntry = [&](size_t i, size_t j, double value) {
+        if (model != NULL) return; // K is cached
+        if (diskK != NULL) {
+            diskK->add(i, j, value);
+            return;
+        }
+        entryRows.push_back(i);
+        entryColumns.push_back(j);
+        entryValues.push_back(value);
+    };
+    pipeline.sync("assemble", [&](SStage &stage) {
+        vector<pair<size_t, TElement*> > batch;
+        try {
+            while (elementQueue.pop(batch, stage.stall)) {
+                for (size_t b = 0; b < batch.size(); b++) {
+                    pair<size_t, TElement*> &item = batch[b];
+                    if (F == NULL) loadProblem();
+                    if ( verbosityLevel >= 2) TLogLine(TSLog::DEBUG, TSLog::ELEMENT) << "Processing element " << item.first << endl;
+                    
+                    TElement *OElement = item.second;
+                    TSAssembly::addElement(OElement, materials, conditions, F, addEntry, verbosityLevel);
+                    if (sensitivity != NULL && model == NULL) sensitivity->addWeights(OElement);
+                    if (outOfCore) delete OElement;
+                }
+                TSMetrics::count("elementsAssembled", batch.size());
+            }
+        } catch (...) {
+            elementQueue.close();
+            throw;
+        }
+    });
+    pipeline.wait();
+    if (TInputParser::getStatus() == TInputParser::FAIL) {
+        throw runtime_error("ERROR: Cannot open the input file.");
     }
+    if (F == NULL) loadProblem(); // no elements at all
     
     /**
      * Printing problem details
@@ -72,123 +425,294 @@ int main(int argc, const char * argv[]) {
         TInputParser::printCoordinates();
         TInputParser::printConnectivities();
         TInputParser::printMaterials();
-        cout << endl;
+        TLogLine(TSLog::TRACE, TSLog::GENERAL) << endl;
     }
     
     /**
-     * Begining of the assembling matrix
+     * Memory alloc and initialization of the needed matrix and vectors
+     * K/F = A
+     * K is sparse, its pattern comes from the connectivities
      **/
-    if ( verbosityLevel >= 1) cout << "Assembling matrixs..." << endl;
+    map<size_t, TElement*> connectivities = (model != NULL) ? model->connectivities : TInputParser::getConnectivities();
+    TSparseMatrix *K = (model != NULL) ? model->K : NULL;
+    gsl_vector *A = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(A, 0);
+    
+    // Fixed temperature nodes are left as identity rows with F as the fixed T
+    map<size_t, SCondition>::iterator it;
+    for (it = conditions.begin(); it != conditions.end(); it++) {
+        if (it->second.type != "Temperature") continue;
+        addEntry(it->first - 1, it->first - 1, 1);
+        gsl_vector_set(F, it->first - 1, it->second.temperature);
+    }
     
     /**
-     * Getting information of the Input static object
+     * Convection and flux integrals over the loaded boundary edges
+     * A cached model keeps its edges, only their values are new
      **/
-    map<size_t, TElement*> connectivities   = TInputParser::getConnectivities();
-    map<size_t, SCondition> conditions      = TInputParser::getConditions();
-    map<size_t, SMaterial> materials        = TInputParser::getMaterials();
+    TBoundary *edges = (model != NULL) ? model->edges : TInputParser::getBoundary();
+    if (model != NULL) edges->setValues(conditions);
+    pipeline.sync("boundary", [&](SStage &) {
+        edges->assemble(F, addEntry);
+    });
+    TLogLine(TSLog::DEBUG, TSLog::ASSEMBLY) << "Boundary edges: convection (" << edges->getAmountOfEdges(TBoundary::CONVECTION) << ") flux ("
+                                            << edges->getAmountOfEdges(TBoundary::FLUX) << ")" << endl;
+    
+    pipeline.sync("scatter", [&](SStage &) {
+        if (model != NULL) return;
+        if (diskK != NULL) {
+            diskK->finalize();
+            return;
+        }
+        K = new TSparseMatrix(connectivities, amountOfNodes);
+        for (size_t e = 0; e < entryValues.size(); e++) K->add(entryRows[e], entryColumns[e], entryValues[e]);
+        vector<size_t>().swap(entryRows);
+        vector<size_t>().swap(entryColumns);
+        vector<double>().swap(entryValues);
+    });
+    if (TSMetrics::isEnabled()) {
+        TSMetrics::set("nodes", amountOfNodes);
+        TSMetrics::set("elements", amountOfElements);
+        TSMetrics::set("nonZeros", (K != NULL) ? K->getNonZeros() : diskK->getNonZeros());
+    }
+    if (diskK != NULL) {
+        TLogLine(TSLog::INFO, TSLog::ASSEMBLY) << "Out of core K: spilled runs (" << diskK->getAmountOfRuns() << ") stored values (" << diskK->getNonZeros() << ")" << endl;
+    }
+    
+    if (guess != NULL) {
+        map<size_t, SNode> coordinates = TInputParser::getCoordinates();
+        if (coordinates.empty()) { // a cached model only has its elements
+            map<size_t, TElement*>::iterator it;
+            for (it = connectivities.begin(); it != connectivities.end(); it++)
+                coordinates.insert(it->second->nodes.begin(), it->second->nodes.end());
+        }
+        guess->apply(coordinates, A);
+        TLogLine line(TSLog::INFO, TSLog::SOLVER);
+        line << "Initial guess mapped by " << guess->getMapping();
+        if (guess->getOutside() > 0) line << ", nodes outside the previous mesh (" << guess->getOutside() << ")";
+        line << endl;
+    }
     
     /**
-     * Memory alloc and initialization of the needed matrix and vectors
-     * K/F = A
+     * Saving the assembled global K/F if verbosity >= 2
+     * Matrix Market files <name>.K.mtx and <name>.F.mtx, far too large for the console
      **/
-    gsl_matrix *K = gsl_matrix_alloc(amountOfNodes, amountOfNodes); gsl_matrix_set_all(K, 0);
-    gsl_vector *F = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(F, 0);
-    gsl_vector *A = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(A, 0);
+    if (verbosityLevel >= 2) {
+        TLogLine line(TSLog::DEBUG, TSLog::ASSEMBLY);
+        line << endl << "Equation system matrix assembled" << endl;
+        if (K != NULL) {
+            K->saveMatrixMarket(TCommandLine::getProblemName() + ".K.mtx");
+            line << "K: " << TCommandLine::getProblemName() << ".K.mtx" << endl;
+        }
+        TSGsl::gsl_save_vector(TCommandLine::getProblemName() + ".F.mtx", *F);
+        line << "F: " << TCommandLine::getProblemName() << ".F.mtx" << endl << endl;
+    }
     
     /**
-     * For each element in the problem we calculate k and f
+     * Solving stage: condensation, solver and back substitution
      **/
-    for (size_t i = 1; i <= amountOfElements; i++) {
-        if ( verbosityLevel >= 2) cout << "Processing element " << i << endl;
-        
-        // Getting the element from the conectivities array.
-        TElement *OElement  = connectivities[i];
-        size_t amountOfNPE  = OElement->nodes.size(); // Nodes per element
+    string solverName;
+    pipeline.sync("solve", [&](SStage &) {
+        /**
+         * Static condensation of the repeated substructures tagged in the input file
+         * Only their boundary nodes and the untagged nodes go to the solver,
+         * Ks/Fs = As is the system actually solved
+         **/
+        map<size_t, size_t> substructures = TInputParser::getSubstructures();
+        TCondensation *condensation = (model != NULL) ? model->condensation : NULL;
+        TSparseMatrix *Ks = K;
+        gsl_vector *Fs = F;
+        gsl_vector *As = A;
+        if (model == NULL && K != NULL && !substructures.empty() && !TCommandLine::hasOption("no-condensation")) {
+            TLogLine(TSLog::INFO, TSLog::SOLVER) << "Condensing substructures..." << endl;
+            TScopedTimer timer("solve.condensation");
+            condensation = new TCondensation(K, connectivities, conditions, substructures);
+        } else if (K == NULL && !substructures.empty()) {
+            TLogLine(TSLog::WARNING, TSLog::SOLVER) << "WARNING: Substructures are not condensed out of core" << endl;
+        }
+        if (condensation != NULL) {
+            TSMetrics::set("reducedNodes", condensation->getReducedSize());
+            Ks = condensation->getReducedMatrix();
+            Fs = condensation->condense(F);
+            As = gsl_vector_alloc(Ks->getSize()); gsl_vector_set_all(As, 0);
+            TLogLine(TSLog::INFO, TSLog::SOLVER) << "Substructure copies (" << condensation->getAmountOfCopies() << ")"
+                                                 << " superelements (" << condensation->getAmountOfSuperelements() << ")"
+                                                 << " reduced nodes (" << condensation->getReducedSize() << ")" << endl;
+        }
         
-        // Getting some element properties
-        long double conductivity  = materials[OElement->getMaterialId()].conductivity;
-        long double convectivity  = materials[OElement->getMaterialId()].convectivity;
+        /**
+         * Solver backend from --solver=<name>, by default chosen from the problem size
+         * Out of core K only lives on disk so it is always solved by streaming it
+         **/
+        TLinearSolver *solver = NULL;
+        if (model != NULL) {
+            solver = model->solver;
+        } else if (diskK != NULL) {
+            solver = new TOutOfCoreSolver(diskK);
+        } else {
+            string solverName = TCommandLine::getOption("solver", "auto");
+            if (solverName == "auto") solverName = TLinearSolver::selectAuto(Ks);
+            solver = TLinearSolver::create(solverName);
+            if (solver == NULL) throw runtime_error("ERROR: Unknown solver " + solverName + ".");
+        }
+        solverName = solver->getName();
+        SSolverOptions solverOptions;
+        solverOptions.tolerance     = TCommandLine::getOption("tolerance", 1e-10);
+        solverOptions.maxIterations = (size_t)TCommandLine::getOption("max-iterations", 0.0);
+        solverOptions.subdomains    = (size_t)TCommandLine::getOption("subdomains", 0.0);
+        solverOptions.overlap       = (size_t)TCommandLine::getOption("overlap", 1.0);
+        solver->setOptions(solverOptions);
         
-        // Getting k element conductivity contribution
-        gsl_matrix *ke  = OElement->getKd(conductivity);
+        /**
+         * Checkpoints of the iterative solvers every --checkpoint=<seconds> (600 by
+         * default) saved as <name>.ckpt, --restart resumes from the last one
+         **/
+        TCheckpoint *checkpoint = NULL;
+        if (TCommandLine::hasOption("checkpoint") || TCommandLine::hasOption("restart")) {
+            size_t key = TCheckpoint::getKey(TInputParser::getSectionHashes(), solver->getName());
+            checkpoint = new TCheckpoint(TCommandLine::getProblemName() + ".ckpt", key, TCommandLine::getOption("checkpoint", 600.0),
+                                         TCommandLine::hasOption("restart"));
+            solver->setCheckpoint(checkpoint);
+        }
         
-        // Getting k element convection contribution if any
-        gsl_matrix *km  = OElement->getKm(convectivity);
+        TLogLine(TSLog::INFO, TSLog::SOLVER) << "Solving using " << solver->getName() << " solver" << (model != NULL ? " (cached factorization)..." : "...") << endl;
         
-        // Getting element boundary condition contributions
-        gsl_vector *fe  = OElement->getF(); // f element contribution (Fix temperature if any)
-        gsl_vector *fec = OElement->getFConvection(convectivity); // f element convection contribution
-        gsl_vector *fef = OElement->getFFlux(convectivity); // f element flux contribution
+        /**
+         * Solving linear K/F equation
+         * analyze (ordering), factorize (or preconditioner setup) and solve
+         * A cached model is already factorized
+         **/
+        if (model == NULL) {
+            if (condensation == NULL) solver->setMesh(connectivities); // the reduced nodes are not the mesh ones
+            {
+                TScopedTimer timer("solve.analyze");
+                solver->analyze(Ks);
+            }
+            TScopedTimer timer("solve.factorize");
+            solver->factorize(Ks);
+        }
+        if (guess != NULL) {
+            if (condensation != NULL) condensation->restrict(A, As); // A is the initial guess
+        } else if (model != NULL && model->solution != NULL) {
+            gsl_vector_memcpy(As, model->solution); // warm start of the iterative solvers
+        }
+        {
+            TScopedTimer timer("solve.solve");
+            solver->solve(Fs, As);
+        }
+        if (checkpoint != NULL) {
+            solver->setCheckpoint(NULL); // the adjoint and the next jobs are not checkpointed
+            TLogLine(TSLog::INFO, TSLog::SOLVER) << (checkpoint->hasResumed() ? "Resumed from the checkpoint, c" : "C")
+                                                 << "heckpoints written (" << checkpoint->getWritten() << ")" << endl;
+            delete checkpoint;
+        }
+        if (TSMetrics::isEnabled()) {
+            TSMetrics::set("solverIterations", solver->getIterations());
+            TSMetrics::set("solverResidual", solver->getResidual());
+            TSMetrics::set("factorSize", solver->getFactorSize());
+        }
         
-        // Printing values Ks and Fs for the element if verbosity >= 3
-        if (verbosityLevel >= 3) {
-            cout << "Element K: " << endl; TSGsl::gsl_show_matrix(*ke); cout << endl;
-            cout << "Element Km: " << endl; TSGsl::gsl_show_matrix(*km); cout << endl;
-            
-            cout << "Element F: " << endl; TSGsl::gsl_show_vector(*fe); cout << endl;
-            cout << "Element Fc: " << endl; TSGsl::gsl_show_vector(*fec); cout << endl;
-            cout << "Element Ff: " << endl; TSGsl::gsl_show_vector(*fef); cout << endl;
+        {
+            TLogLine line(TSLog::INFO, TSLog::SOLVER);
+            line << "Stored factor values (" << solver->getFactorSize() << ")";
+            if (solver->getIterations() > 0) line << " iterations (" << solver->getIterations() << ") residual (" << solver->getResidual() << ")";
+            line << endl;
+        }
+        if (!solver->hasConverged()) {
+            TLogLine(TSLog::WARNING, TSLog::SOLVER) << "WARNING: " << solver->getName() << " solver did not converge, residual (" << solver->getResidual() << ")" << endl;
         }
         
         /**
-         * For each node in the element we get contribution values for the global K/F assembling
+         * Adjoint system K l = c of the functional, with the same factorization
+         * (or preconditioner) and the same condensation as K A = F
          **/
-        gsl_matrix_add(ke, km);
-        vector<size_t> nodeIds = OElement->getNodeIds();
-        for (size_t j = 0; j < amountOfNPE; j++) {
-            size_t nodeJ = nodeIds[j] - 1;
-            // Element ke into global K
-            for (size_t k = 0; k < amountOfNPE; k++) {
-                size_t nodeK = nodeIds[k] - 1;
-                long double value = gsl_matrix_get(K, nodeJ, nodeK);
-                value += gsl_matrix_get(ke, j, k);
-                gsl_matrix_set(K, nodeJ, nodeK, value);
+        if (sensitivity != NULL) {
+            TScopedTimer timer("solve.adjoint");
+            if (model != NULL) {
+                map<size_t, TElement*>::iterator it;
+                for (it = connectivities.begin(); it != connectivities.end(); it++) sensitivity->addWeights(it->second);
             }
-            
-            gsl_vector_set(F, nodeJ, gsl_vector_get(F, nodeJ) + gsl_vector_get(fec, j)); // element convection into global F
-            gsl_vector_set(F, nodeJ, gsl_vector_get(F, nodeJ) + gsl_vector_get(fef, j)); // element flux into global F
-            
-            // If fixed temperature we set F as fixed T in the node position
-            // and K row as 1 for the current fixed temperature node position
-            // and ceros for any other node position
-            if (conditions.find(nodeIds[j]) != conditions.end() && (conditions[nodeIds[j]].type == "Temperature")) {
-                gsl_vector_set(F, nodeJ, gsl_vector_get(fe, j));
-                gsl_vector *vecTmp;
-                vecTmp = gsl_vector_alloc(amountOfNodes);
-                gsl_vector_set_all(vecTmp, 0);
-                gsl_vector_set(vecTmp, nodeJ, 1);
-                gsl_matrix_set_row(K, nodeJ, vecTmp);
+            gsl_vector *c = sensitivity->getWeights(amountOfNodes);
+            gsl_vector *adjoint = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(adjoint, 0);
+            if (condensation != NULL) {
+                gsl_vector *cs = condensation->condense(c);
+                gsl_vector *adjoints = gsl_vector_alloc(Ks->getSize()); gsl_vector_set_all(adjoints, 0);
+                solver->solve(cs, adjoints);
+                condensation->recover(adjoints, c, adjoint);
+                gsl_vector_free(cs);
+                gsl_vector_free(adjoints);
+            } else {
+                solver->solve(c, adjoint);
             }
+            sensitivity->setAdjoint(adjoint, conditions);
+            TLogLine line(TSLog::INFO, TSLog::SOLVER);
+            line << "Adjoint solve";
+            if (solver->getIterations() > 0) line << " iterations (" << solver->getIterations() << ") residual (" << solver->getResidual() << ")";
+            line << endl;
         }
-    }
-
-    // Just printing the assembled global K/F if verbosity >= 2
-    if (verbosityLevel >= 2) {
-        cout << endl << "Equation system matrix assembled" << endl;
-        cout << "K: " << endl; TSGsl::gsl_show_matrix(*K); cout << endl;
-        cout << "F: " << endl; TSGsl::gsl_show_vector(*F); cout << endl;
-    }
-    
-    if (verbosityLevel >= 1)
-        cout << "Solving using linal Householder solver (gsl_linalg_HH_solve)..." << endl;
-    
-    /**
-     * Solving linear K/F equation using House Holder solver
-     **/
-    gsl_linalg_HH_solve(K, F, A);
+        delete diskK; // its files are removed too
+        
+        // The initial guess of the next solve of this model
+        gsl_vector *solution = NULL;
+        if (cache != NULL && !outOfCore) {
+            solution = gsl_vector_alloc(As->size);
+            gsl_vector_memcpy(solution, As);
+        }
+        
+        // Interior temperatures of the substructures by back substitution
+        if (condensation != NULL) {
+            TScopedTimer timer("solve.recover");
+            condensation->recover(As, F, A);
+            TLogLine(TSLog::INFO, TSLog::SOLVER) << "Stored superelement values (" << condensation->getFactorSize() << ")" << endl;
+            gsl_vector_free(Fs);
+            gsl_vector_free(As);
+        }
+        
+        /**
+         * Server mode keeps the model for the next jobs, with the elements
+         * that have conditioned nodes as its boundary
+         **/
+        if (model == NULL && cache != NULL && !outOfCore) {
+            model = new SCachedModel();
+            model->connectivities = connectivities;
+            model->K = K;
+            model->edges = edges;
+            model->condensation = condensation;
+            model->solver = solver;
+            map<size_t, TElement*>::iterator it;
+            for (it = connectivities.begin(); it != connectivities.end(); it++) {
+                vector<size_t> nodeIds = it->second->getNodeIds();
+                for (size_t j = 0; j < nodeIds.size(); j++) {
+                    if (conditions.find(nodeIds[j]) == conditions.end()) continue;
+                    model->boundary.push_back(*it);
+                    break;
+                }
+            }
+            cache->store(modelKey, model);
+        } else if (model == NULL) {
+            delete solver;
+            delete condensation;
+        }
+        if (solution != NULL) {
+            if (model->solution != NULL) gsl_vector_free(model->solution);
+            model->solution = solution;
+        }
+    });
 
-    // Printing the Temperature distribution obtained from K/F resolution
+    // Saving the Temperature distribution obtained from K/F resolution (<name>.A.mtx)
     if (verbosityLevel >= 2) {
-        cout << "Temperature disribution: " << endl; TSGsl::gsl_show_vector(*A); cout << endl;
+        TSGsl::gsl_save_vector(TCommandLine::getProblemName() + ".A.mtx", *A);
+        TLogLine(TSLog::DEBUG, TSLog::SOLVER) << "Temperature disribution: " << TCommandLine::getProblemName() << ".A.mtx" << endl << endl;
     }
     
-    if (verbosityLevel >= 1) cout << "Estimating Flux Heat vectors..." << endl;
+    TLogLine(TSLog::INFO, TSLog::FLUX) << "Estimating Flux Heat vectors..." << endl;
     
     /**
-     * Really poor gradient estimation from temperature distribution
-     * TODO: Research and implement a better approach of flux estimation
-     * For example "Super convergent points for the flux"
+     * Generating GID post processing file
+     * The writer stage starts with the Temperature block while the flux is
+     * estimated, the nodal flux values follow by chunks as they are averaged
      **/
+    fileName = TCommandLine::getProblemName() + ".post.res";
+    TLogLine(TSLog::INFO, TSLog::GENERAL) << "Saving result: " << fileName << endl;
     
     // Flux contribution by 2D axes
     gsl_vector *xFlux  = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(xFlux, 0);
@@ -198,81 +722,308 @@ int main(int argc, const char * argv[]) {
     gsl_vector *xFluxC  = gsl_vector_alloc(amountOfNodes);  gsl_vector_set_all(xFluxC, 0);
     gsl_vector *yFluxC  = gsl_vector_alloc(amountOfNodes);  gsl_vector_set_all(yFluxC, 0);
     
-    /**
-     * For each element in the problem...
-     **/
-    for (size_t i = 1; i <= amountOfElements; i++) {
-        TElement *OElement = connectivities[i];
-        size_t amountOfNPE = OElement->nodes.size();
-        long double conductivity = materials[OElement->getMaterialId()].conductivity;
-        long double temp = 0;
+    TBoundedQueue<pair<size_t, size_t> > fluxQueue(FLUX_QUEUE_SIZE); // [first, last) nodes with their flux ready
+    pipeline.async("write", [&](SStage &stage) {
+        ofstream outFile;
+        outFile.open(fileName.c_str());
+        outFile << "GID Post Results File 1.0" << endl;
+        outFile << endl;
+//        outFile << "GaussPoints \"Elements\" ElemType Triangle" << endl;
+//        outFile << "Number Of Gauss Points: 1" << endl;
+//        outFile << "Natural Coordinates: internal" << endl;
+//        outFile << "end gausspoints" << endl;
+        outFile << endl;
+        outFile << "Result \"Temperature\" \"LOAD ANALISYS\" 1 Scalar OnNodes" << endl;
+        outFile << "Values" << endl;
+        for (size_t i = 0; i < amountOfNodes; i++)
+            outFile << i+1 << " " << gsl_vector_get(A, i) << endl;
+        
+        outFile << "End values" << endl;
+        outFile << endl;
         
-        vector<size_t> nodeIds = OElement->getNodeIds();
-        // Getting the avg of nodal temperatures
-        for (size_t j = 0; j < amountOfNPE; j++) {
-            temp += gsl_vector_get(A, nodeIds[j] - 1);
+//        outFile << "Result \"Flux\" \"LOAD ANALISYS\" 1 Vector OnGaussPoints \"Elements\"" << endl;
+        outFile << "Result \"Flux\" \"LOAD ANALISYS\" 1 Vector OnNodes" << endl;
+        outFile << "Values" << endl;
+        pair<size_t, size_t> chunk;
+        while (fluxQueue.pop(chunk, stage.stall)) {
+            for (size_t i = chunk.first; i < chunk.second; i++)
+                outFile << i+1 << " " << gsl_vector_get(xFlux, i) << " " << gsl_vector_get(yFlux, i) << " 0" << endl;
         }
-        temp /= amountOfNPE;
         
-        // For each node in element
-        for (size_t j = 0; j < amountOfNPE; j++) {
-            size_t nodeJ = nodeIds[j] - 1;
-            SDiff nDiff = OElement->getCenterDiff(j); // Distance to the centroid
-            long double kT = conductivity * (gsl_vector_get(A, nodeJ) - temp); // conductivity * delta temperature
-            
-            if ( abs(nDiff.x) > DBL_EPSILON ) { // if distance is to small we avoid dividing by 0
-                gsl_vector_set(xFluxC, nodeJ, gsl_vector_get(xFluxC, nodeJ) + 1); // counting node contributions
-                gsl_vector_set(xFlux, nodeJ, gsl_vector_get(xFlux, nodeJ) + (kT / nDiff.x)); // Adding element x flux contribution to the node
+        outFile << "End values" << endl;
+        
+        outFile.close();
+    });
+    
+    // Flux contribution of one element to its nodes
+    auto accumulateFlux = [&](size_t id, TElement *OElement) {
+        TSAssembly::addFlux(OElement, materials, A, xFlux, yFlux, xFluxC, yFluxC);
+        if (probes != NULL) probes->addElement(id, OElement);
+        if (raster != NULL) raster->addElement(OElement);
+        if (sensitivity != NULL) sensitivity->addElement(OElement, materials, A);
+    };
+    
+    pipeline.sync("flux", [&](SStage &stage) {
+        try {
+            /**
+             * For each element in the problem...
+             * Out of core the elements are read again from the input file
+             **/
+            if (!outOfCore) {
+                for (size_t i = 1; i <= amountOfElements; i++) accumulateFlux(i, connectivities[i]);
+            } else {
+                TInputParser::reset();
+                TInputParser::setElementHook([&](size_t id, TElement *OElement) {
+                    accumulateFlux(id, OElement);
+                    delete OElement;
+                });
+                TInputParser::readFile(TCommandLine::getProblemName() + ".dat");
             }
             
-            if ( abs(nDiff.y) > DBL_EPSILON ) { // if distance is to small we avoid dividing by 0
-                gsl_vector_set(yFluxC, nodeJ, gsl_vector_get(yFluxC, nodeJ) + 1); // counting node contributions
-                gsl_vector_set(yFlux, nodeJ, gsl_vector_get(yFlux, nodeJ) + (kT / nDiff.y)); // Adding element y flux contribution to the node
+            // Getting nodal flux avg. values and handing them to the writer
+            for (size_t first = 0; first < amountOfNodes; first += FLUX_CHUNK_SIZE) {
+                size_t last = min(first + FLUX_CHUNK_SIZE, amountOfNodes);
+                for (size_t i = first; i < last; i++) {
+                    gsl_vector_set(xFlux, i, gsl_vector_get(xFlux, i) / gsl_vector_get(xFluxC, i));
+                    gsl_vector_set(yFlux, i, gsl_vector_get(yFlux, i) / gsl_vector_get(yFluxC, i));
+                }
+                fluxQueue.push(make_pair(first, last), stage.stall);
             }
+        } catch (...) {
+            fluxQueue.close();
+            throw;
         }
+        fluxQueue.close();
+    });
+    pipeline.wait();
+    
+    // Locating the probes in the solved mesh and interpolating T and flux there
+    if (probes != NULL) {
+        pipeline.sync("probes", [&](SStage &) {
+            string probesName = TCommandLine::getProblemName() + ".probes";
+            probes->evaluate(A, xFlux, yFlux);
+            probes->write(probesName);
+            TLogLine(TSLog::INFO, TSLog::GENERAL) << "Probes: " << probes->getAmountOfProbes() << " (outside the mesh "
+                                                  << probes->getOutside() << "), saving result: " << probesName << endl;
+        });
+        delete probes;
+    }
+    
+    // Rasterizing the nodal values by tiles of pixels on every core
+    if (raster != NULL) {
+        pipeline.sync("raster", [&](SStage &) {
+            string format = raster->getFormat();
+            raster->rasterize(A, xFlux, yFlux);
+            raster->write(TCommandLine::getProblemName());
+            TLogLine(TSLog::INFO, TSLog::GENERAL) << "Raster: " << raster->getColumns() << "x" << raster->getRows() << " (covered pixels "
+                                                  << raster->getCovered() << "), saving result: " << TCommandLine::getProblemName()
+                                                  << ".T." << format << " and " << TCommandLine::getProblemName() << ".flux." << format << endl;
+        });
+        delete raster;
     }
     
-    gsl_vector_div(xFlux, xFluxC); // getting nodal x flux avg. value
-    gsl_vector_div(yFlux, yFluxC); // getting nodal y flux avg. value
+    // Element terms were added with the flux, the edge terms and J are left
+    if (sensitivity != NULL) {
+        pipeline.sync("sensitivity", [&](SStage &) {
+            string sensitivityName = TCommandLine::getProblemName() + ".sensitivity";
+            sensitivity->addBoundary(edges, A);
+            sensitivity->write(sensitivityName);
+            TLogLine(TSLog::INFO, TSLog::GENERAL) << "Functional (" << sensitivity->getValue() << "), saving sensitivities: " << sensitivityName << endl;
+        });
+        delete sensitivity;
+    }
 
-    // Printing flux if verbosity >= 3
+    // Saving flux if verbosity >= 3 (<name>.xFlux.mtx and <name>.yFlux.mtx)
     if (verbosityLevel >= 3) {
-        cout << "Flux X: " << endl; TSGsl::gsl_show_vector(*xFlux); cout << endl;
-        cout << "Flux Y: " << endl; TSGsl::gsl_show_vector(*yFlux); cout << endl;
+        TSGsl::gsl_save_vector(TCommandLine::getProblemName() + ".xFlux.mtx", *xFlux);
+        TSGsl::gsl_save_vector(TCommandLine::getProblemName() + ".yFlux.mtx", *yFlux);
+        TLogLine(TSLog::TRACE, TSLog::FLUX) << "Flux X: " << TCommandLine::getProblemName() << ".xFlux.mtx" << endl
+                                            << "Flux Y: " << TCommandLine::getProblemName() << ".yFlux.mtx" << endl << endl;
+    }
+    
+    if (verbosityLevel >= 1) pipeline.printReport();
+    
+    // The estimate of the solver that actually ran against the peak resident size and the tracked peak (operator new only, when tracking)
+    if (planner != NULL) {
+        size_t estimated = outOfCore ? planner->estimateOutOfCore(memoryBudget) : planner->estimate(solverName);
+        if (!outOfCore && TCommandLine::getOption("solver", "auto") == "auto") estimated = max(estimated, planner->estimate("auto"));
+        TSMetrics::set("memoryEstimate", estimated);
+        TLogLine line(TSLog::INFO, TSLog::GENERAL);
+        line << "Memory estimate (" << estimated / MB << " MB) resident peak (" << TSMetrics::getPeakMemory() / MB << " MB)";
+        if (TSMetrics::isTracking()) line << " tracked peak (" << TSMetrics::getPeakBytes() / MB << " MB)";
+        line << endl;
+        delete planner;
     }
+    TSLog::printSummary();
     
+    if (results != NULL) {
+        results->store(resultKey, fileName);
+        delete results;
+    }
+    delete guess;
+    saveMetrics();
     
     /**
-     * Generating GID post processing file
+     * Releasing the problem (the server keeps running after it)
+     * A cached model keeps K and the elements
      **/
-    fileName = (string)argv[1] + ".post.res";
-    if (verbosityLevel >= 1) cout << "Saving result: " << fileName << endl;
-    ofstream outFile;
-    outFile.open(fileName.c_str());
-    outFile << "GID Post Results File 1.0" << endl;
-    outFile << endl;
-//    outFile << "GaussPoints \"Elements\" ElemType Triangle" << endl;
-//    outFile << "Number Of Gauss Points: 1" << endl;
-//    outFile << "Natural Coordinates: internal" << endl;
-//    outFile << "end gausspoints" << endl;
-    outFile << endl;
-    outFile << "Result \"Temperature\" \"LOAD ANALISYS\" 1 Scalar OnNodes" << endl;
-    outFile << "Values" << endl;
-    for (size_t i = 0; i < amountOfNodes; i++)
-        outFile << i+1 << " " << gsl_vector_get(A, i) << endl;
-    
-    outFile << "End values" << endl;
-    outFile << endl;
-    
-//    outFile << "Result \"Flux\" \"LOAD ANALISYS\" 1 Vector OnGaussPoints \"Elements\"" << endl;
-    outFile << "Result \"Flux\" \"LOAD ANALISYS\" 1 Vector OnNodes" << endl;
-    outFile << "Values" << endl;
-    for (size_t i = 0; i < amountOfNodes; i++)
-        outFile << i+1 << " " << gsl_vector_get(xFlux, i) << " " << gsl_vector_get(yFlux, i) << " 0" << endl;
-    
-    outFile << "End values" << endl;
+    gsl_vector_free(F);
+    gsl_vector_free(A);
+    gsl_vector_free(xFlux);
+    gsl_vector_free(yFlux);
+    gsl_vector_free(xFluxC);
+    gsl_vector_free(yFluxC);
+    if (model == NULL) {
+        delete K;
+        delete edges;
+        map<size_t, TElement*>::iterator element;
+        for (element = connectivities.begin(); element != connectivities.end(); element++) delete element->second;
+    }
+    
+    return 0;
+}
+
+/**
+ * Reduced order model of the problem (see TReducedModel)
+ * Every line of the samples and queries files is a set of parameters,
+ * "k<material>=<value> h<material>=<value> b<block>=<value>" in the units of
+ * the input file (blocks by file order, "#" for comments)
+ * --rom-train=<samples>     full solutions of the samples, saved as <name>.rom
+ *                           (--rom-modes=<max modes>, --rom-energy=<left out energy>)
+ * --rom=<model>             queries of --rom-query=<queries>, <name>.rom by default
+ *                           saved as <name>.rom.post.res (--rom-nodes=<id>,... only those nodes)
+ *                           a query with a relative residual over --rom-tolerance is solved in full
+ **/
+static int reduce() {
+    string fileName = TCommandLine::getProblemName() + ".dat";
+    TSLog::configure(TCommandLine::getVerbosityLevel());
+    struct SLogFlush { ~SLogFlush() { TSLog::flush(); } } logFlush;
+    TSReduction::setReproducible(TCommandLine::hasOption("reproducible"));
+    
+    auto readLines = [](string name) {
+        ifstream inFile(name.c_str());
+        if (!inFile.is_open()) throw runtime_error("ERROR: Cannot open the parameters file " + name + ".");
+        vector<string> lines;
+        string line;
+        while (getline(inFile, line)) {
+            vector<string> tmp = TSString::split(line, " \t\r");
+            if (tmp.empty() || tmp[0][0] == '#') continue;
+            lines.push_back(line);
+        }
+        return lines;
+    };
+    
+    // The full model, built when training and for the first query the reduced model cannot answer
+    map<size_t, TElement*> connectivities;
+    TBoundary *edges = NULL;
+    TAffineModel *full = NULL;
+    auto buildModel = [&]() {
+        TScopedTimer timer("rom.model");
+        TInputParser::setKeepElements(true);
+        TInputParser::reset();
+        TInputParser::readFile(fileName);
+        if (TInputParser::getStatus() == TInputParser::FAIL) throw runtime_error("ERROR: Cannot open the input file.");
+        connectivities = TInputParser::getConnectivities();
+        map<size_t, SMaterial> materials = TInputParser::getMaterials();
+        vector<SConditionGroup> groups = TInputParser::getGroups();
+        edges = TInputParser::getBoundary();
+        full = new TAffineModel(connectivities, materials, groups, edges, TInputParser::getAmountOfNodes());
+    };
+    auto releaseModel = [&]() {
+        delete full;
+        delete edges;
+        map<size_t, TElement*>::iterator element;
+        for (element = connectivities.begin(); element != connectivities.end(); element++) delete element->second;
+    };
+    
+    TReducedModel rom;
+    if (TCommandLine::hasOption("rom-train")) {
+        TLogLine(TSLog::INFO, TSLog::GENERAL) << "Reading input file: " << fileName << endl;
+        buildModel();
+        vector<string> lines = readLines(TCommandLine::getOption("rom-train", ""));
+        vector<SParameters> samples;
+        for (size_t s = 0; s < lines.size(); s++)
+            samples.push_back(TAffineModel::parseParameters(lines[s], full->getBase(), full->getGroups(), TInputParser::getFactor()));
+        TLogLine(TSLog::INFO, TSLog::GENERAL) << "Training the reduced model with " << samples.size() << " samples of "
+                                              << TInputParser::getAmountOfNodes() << " nodes..." << endl;
+        {
+            TScopedTimer timer("rom.train");
+            rom.train(*full, samples, (size_t)TCommandLine::getOption("rom-modes", 0.0), TCommandLine::getOption("rom-energy", 1e-12),
+                      TInputParser::getModelHash(), TInputParser::getFactor());
+        }
+        releaseModel();
+        string romName = TCommandLine::getProblemName() + ".rom";
+        rom.save(romName);
+        vector<double> singularValues = rom.getSingularValues();
+        TLogLine line(TSLog::INFO, TSLog::GENERAL);
+        line << "Modes (" << rom.getModes() << ") singular values (";
+        for (size_t s = 0; s < singularValues.size(); s++) line << (s ? ", " : "") << singularValues[s];
+        line << ")" << endl << "Saving reduced model: " << romName << endl;
+        return 0;
+    }
     
+    string romName = TCommandLine::getOption("rom", "");
+    if (romName.empty()) romName = TCommandLine::getProblemName() + ".rom";
+    rom.load(romName);
+    
+    // A quick read without the geometry, the reduced model must come from this mesh
+    TInputParser::setReadGeometry(false);
+    TInputParser::reset();
+    TInputParser::readFile(fileName);
+    TInputParser::setReadGeometry(true);
+    if (TInputParser::getStatus() == TInputParser::FAIL) throw runtime_error("ERROR: Cannot open the input file.");
+    if (TInputParser::getModelHash() != rom.getModelHash()) throw runtime_error("ERROR: The reduced model " + romName + " was trained on another model.");
+    
+    vector<size_t> nodes;
+    vector<string> ids = TSString::split(TCommandLine::getOption("rom-nodes", ""), ",");
+    for (size_t i = 0; i < ids.size(); i++) {
+        size_t node = (size_t)atol(ids[i].c_str());
+        if (node < 1 || node > rom.getSize()) throw runtime_error("ERROR: Wrong node \"" + ids[i] + "\" in --rom-nodes.");
+        nodes.push_back(node);
+    }
+    
+    vector<string> lines = readLines(TCommandLine::getOption("rom-query", ""));
+    double tolerance = TCommandLine::getOption("rom-tolerance", 1e-3);
+    gsl_vector *a = gsl_vector_alloc(rom.getModes());
+    gsl_vector *A = gsl_vector_alloc(rom.getSize()); gsl_vector_set_all(A, 0);
+    size_t fullSolves = 0;
+    
+    string resultName = TCommandLine::getProblemName() + ".rom.post.res";
+    ofstream outFile(resultName.c_str());
+    outFile << "GID Post Results File 1.0" << endl;
+    for (size_t q = 0; q < lines.size(); q++) {
+        SParameters parameters = rom.parseParameters(lines[q]);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        double indicator = rom.query(parameters, a);
+        bool reduced = indicator <= tolerance;
+        if (!reduced) {
+            if (full == NULL) buildModel();
+            full->solve(parameters, A);
+            fullSolves++;
+        } else if (nodes.empty()) {
+            rom.getTemperatures(parameters, a, A);
+        }
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        TLogLine(TSLog::INFO, TSLog::GENERAL) << "Query " << q + 1 << (reduced ? " reduced" : " full") << " (residual "
+                                              << indicator << ") " << elapsed * 1000 << " ms" << endl;
+        
+        outFile << endl;
+        outFile << "Result \"Temperature\" \"ROM QUERY\" " << q + 1 << " Scalar OnNodes" << endl;
+        outFile << "Values" << endl;
+        if (nodes.empty()) {
+            for (size_t i = 0; i < rom.getSize(); i++) outFile << i+1 << " " << gsl_vector_get(A, i) << endl;
+        } else {
+            for (size_t i = 0; i < nodes.size(); i++)
+                outFile << nodes[i] << " " << (reduced ? rom.getTemperature(parameters, a, nodes[i]) : gsl_vector_get(A, nodes[i] - 1)) << endl;
+        }
+        outFile << "End values" << endl;
+    }
     outFile.close();
     
+    TLogLine(TSLog::INFO, TSLog::GENERAL) << "Queries (" << lines.size() << ") solved in full (" << fullSolves << ") modes ("
+                                          << rom.getModes() << "), saving result: " << resultName << endl;
+    gsl_vector_free(a);
+    gsl_vector_free(A);
+    if (full != NULL) releaseModel();
     return 0;
 }
@@ -0,0 +1,266 @@
+//
+//  TBenchmark.cpp
+//  CFem2DHeatBench
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TBenchmark.hpp"
+#include "TMeshGenerator.hpp"
+#include "TCommandLine.hpp"
+#include "TInputParser.hpp"
+#include "TLinearSolver.hpp"
+#include "TSAssembly.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace std;
+
+TBenchmark::TBenchmark(string directory) : directory(directory) {
+    if (!this->directory.empty() && this->directory.back() != '/') this->directory += "/";
+}
+
+TBenchmark::~TBenchmark() { }
+
+const vector<string> & TBenchmark::getPhases() {
+    static const vector<string> phases = {"parse", "kernels", "assembly", "solve", "flux", "write"};
+    return phases;
+}
+
+void TBenchmark::run(string shape, size_t amountOfNodes, bool perturbed, size_t repeat, bool keep) {
+    SBenchCase OCase;
+    OCase.name = shape + "-" + to_string(amountOfNodes) + (perturbed ? "-perturbed" : "");
+    string fileName = directory + "bench-" + OCase.name;
+    
+    TMeshGenerator generator(shape, amountOfNodes, perturbed);
+    generator.write(fileName + ".dat");
+    OCase.nodes     = generator.getAmountOfNodes();
+    OCase.elements  = generator.getAmountOfElements();
+    
+    map<string, vector<double> > samples;
+    for (size_t r = 0; r < max(repeat, (size_t)1); r++) {
+        map<string, double> phases;
+        runOnce(fileName, phases);
+        map<string, double>::iterator it;
+        for (it = phases.begin(); it != phases.end(); it++) samples[it->first].push_back(it->second);
+    }
+    // Median of the runs of every phase
+    map<string, vector<double> >::iterator st;
+    for (st = samples.begin(); st != samples.end(); st++) {
+        vector<double> &times = st->second;
+        sort(times.begin(), times.end());
+        size_t middle = times.size() / 2;
+        OCase.phases[st->first] = (times.size() % 2) ? times[middle] : (times[middle - 1] + times[middle]) / 2;
+    }
+    cases.push_back(OCase);
+    
+    if (!keep) {
+        unlink((fileName + ".dat").c_str());
+        unlink((fileName + ".post.res").c_str());
+    }
+}
+
+void TBenchmark::runOnce(string fileName, map<string, double> &phases) {
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    auto lap = [&](string phase) {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        chrono::duration<double> elapsed = now - begin;
+        phases[phase] = elapsed.count();
+        begin = now;
+    };
+    
+    // parse
+    TInputParser::reset();
+    TInputParser::setElementHook(nullptr);
+    TInputParser::setKeepElements(true);
+    TInputParser::readFile(fileName + ".dat");
+    if (TInputParser::getStatus() == TInputParser::FAIL) throw runtime_error("ERROR: Cannot open the input file.");
+    size_t amountOfNodes = TInputParser::getAmountOfNodes();
+    map<size_t, SCondition> conditions = TInputParser::getConditions();
+    map<size_t, SMaterial> materials = TInputParser::getMaterials();
+    map<size_t, TElement*> connectivities = TInputParser::getConnectivities();
+    lap("parse");
+    
+    // kernels
+    map<size_t, TElement*>::iterator it;
+    for (it = connectivities.begin(); it != connectivities.end(); it++) {
+        TElement *OElement = it->second;
+        SMaterial &OMaterial = materials[OElement->getMaterialId()];
+        gsl_matrix_free(OElement->getKd(OMaterial.conductivity));
+        OElement->getF();
+    }
+    lap("kernels");
+    
+    // assembly
+    TSparseMatrix *K = new TSparseMatrix(connectivities, amountOfNodes);
+    gsl_vector *F = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(F, 0);
+    gsl_vector *A = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(A, 0);
+    auto addEntry = [&](size_t i, size_t j, double value) { K->add(i, j, value); };
+    for (it = connectivities.begin(); it != connectivities.end(); it++) TSAssembly::addElement(it->second, materials, conditions, F, addEntry, 0);
+    TBoundary *edges = TInputParser::getBoundary();
+    edges->assemble(F, addEntry);
+    delete edges;
+    map<size_t, SCondition>::iterator itc;
+    for (itc = conditions.begin(); itc != conditions.end(); itc++) {
+        if (itc->second.type != "Temperature") continue;
+        K->add(itc->first - 1, itc->first - 1, 1);
+        gsl_vector_set(F, itc->first - 1, itc->second.temperature);
+    }
+    lap("assembly");
+    
+    // solve
+    string solverName = TCommandLine::getOption("solver", "auto");
+    if (solverName == "auto") solverName = TLinearSolver::selectAuto(K);
+    TLinearSolver *solver = TLinearSolver::create(solverName);
+    if (solver == NULL) throw runtime_error("ERROR: Unknown solver " + solverName + ".");
+    SSolverOptions solverOptions;
+    solverOptions.tolerance     = TCommandLine::getOption("tolerance", 1e-10);
+    solverOptions.maxIterations = (size_t)TCommandLine::getOption("max-iterations", 0.0);
+    solverOptions.subdomains    = (size_t)TCommandLine::getOption("subdomains", 0.0);
+    solverOptions.overlap       = (size_t)TCommandLine::getOption("overlap", 1.0);
+    solver->setOptions(solverOptions);
+    solver->setMesh(connectivities);
+    solver->analyze(K);
+    solver->factorize(K);
+    solver->solve(F, A);
+    delete solver;
+    lap("solve");
+    
+    // flux
+    gsl_vector *xFlux  = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(xFlux, 0);
+    gsl_vector *yFlux  = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(yFlux, 0);
+    gsl_vector *xFluxC = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(xFluxC, 0);
+    gsl_vector *yFluxC = gsl_vector_alloc(amountOfNodes); gsl_vector_set_all(yFluxC, 0);
+    for (it = connectivities.begin(); it != connectivities.end(); it++) TSAssembly::addFlux(it->second, materials, A, xFlux, yFlux, xFluxC, yFluxC);
+    for (size_t i = 0; i < amountOfNodes; i++) {
+        gsl_vector_set(xFlux, i, gsl_vector_get(xFlux, i) / gsl_vector_get(xFluxC, i));
+        gsl_vector_set(yFlux, i, gsl_vector_get(yFlux, i) / gsl_vector_get(yFluxC, i));
+    }
+    lap("flux");
+    
+    // write
+    ofstream outFile((fileName + ".post.res").c_str());
+    outFile << "GID Post Results File 1.0" << endl << endl << endl;
+    outFile << "Result \"Temperature\" \"LOAD ANALISYS\" 1 Scalar OnNodes" << endl << "Values" << endl;
+    for (size_t i = 0; i < amountOfNodes; i++) outFile << i+1 << " " << gsl_vector_get(A, i) << endl;
+    outFile << "End values" << endl << endl;
+    outFile << "Result \"Flux\" \"LOAD ANALISYS\" 1 Vector OnNodes" << endl << "Values" << endl;
+    for (size_t i = 0; i < amountOfNodes; i++) outFile << i+1 << " " << gsl_vector_get(xFlux, i) << " " << gsl_vector_get(yFlux, i) << " 0" << endl;
+    outFile << "End values" << endl;
+    outFile.close();
+    lap("write");
+    
+    for (it = connectivities.begin(); it != connectivities.end(); it++) delete it->second;
+    TInputParser::reset();
+    delete K;
+    gsl_vector_free(F);
+    gsl_vector_free(A);
+    gsl_vector_free(xFlux);
+    gsl_vector_free(yFlux);
+    gsl_vector_free(xFluxC);
+    gsl_vector_free(yFluxC);
+}
+
+void TBenchmark::printReport() {
+    for (size_t c = 0; c < cases.size(); c++) {
+        SBenchCase &OCase = cases[c];
+        cout << "Case " << OCase.name << " nodes (" << OCase.nodes << ") elements (" << OCase.elements << ")" << endl;
+        for (size_t p = 0; p < getPhases().size(); p++) {
+            cout << "  " << getPhases()[p] << " (" << OCase.phases[getPhases()[p]] << "s)" << endl;
+        }
+    }
+}
+
+/**
+ * One case per line so the baseline can be read back without a JSON library
+ **/
+void TBenchmark::writeJson(string fileName) {
+    ofstream outFile(fileName.c_str());
+    if (!outFile.is_open()) throw runtime_error("ERROR: Cannot write the file " + fileName + ".");
+    outFile.precision(9);
+    outFile << "{" << endl << "  \"cases\": [" << endl;
+    for (size_t c = 0; c < cases.size(); c++) {
+        SBenchCase &OCase = cases[c];
+        outFile << "    {\"name\": \"" << OCase.name << "\", \"nodes\": " << OCase.nodes << ", \"elements\": " << OCase.elements << ", \"phases\": {";
+        for (size_t p = 0; p < getPhases().size(); p++) {
+            outFile << (p ? ", " : "") << "\"" << getPhases()[p] << "\": " << OCase.phases[getPhases()[p]];
+        }
+        outFile << "}}" << (c + 1 < cases.size() ? "," : "") << endl;
+    }
+    outFile << "  ]" << endl << "}" << endl;
+}
+
+vector<SBenchCase> TBenchmark::readJson(string fileName) {
+    ifstream inFile(fileName.c_str());
+    if (!inFile.is_open()) throw runtime_error("ERROR: Cannot open the baseline " + fileName + ".");
+    auto field = [](string &line, string name) -> string {
+        size_t at = line.find("\"" + name + "\":");
+        if (at == string::npos) return "";
+        at += name.size() + 3;
+        while (at < line.size() && (line[at] == ' ' || line[at] == '"')) at++;
+        size_t end = line.find_first_of("\",}", at);
+        return line.substr(at, end - at);
+    };
+    vector<SBenchCase> baseline;
+    string line;
+    while (getline(inFile, line)) {
+        if (line.find("\"name\"") == string::npos) continue;
+        SBenchCase OCase;
+        OCase.name      = field(line, "name");
+        OCase.nodes     = atoi(field(line, "nodes").c_str());
+        OCase.elements  = atoi(field(line, "elements").c_str());
+        for (size_t p = 0; p < getPhases().size(); p++) {
+            string value = field(line, getPhases()[p]);
+            if (!value.empty()) OCase.phases[getPhases()[p]] = atof(value.c_str());
+        }
+        baseline.push_back(OCase);
+    }
+    return baseline;
+}
+
+/**
+ * Phase by phase ratio with the baseline cases of the same name, returns the amount of regressions
+ * A phase only regresses when it is also slower by more than minimumDelta seconds
+ **/
+size_t TBenchmark::compare(vector<SBenchCase> &baseline, double threshold, double minimumDelta) {
+    size_t regressions = 0;
+    for (size_t c = 0; c < cases.size(); c++) {
+        SBenchCase &OCase = cases[c];
+        SBenchCase *OBase = NULL;
+        for (size_t b = 0; b < baseline.size(); b++) if (baseline[b].name == OCase.name) OBase = &baseline[b];
+        if (OBase == NULL) {
+            cout << "Case " << OCase.name << " is not in the baseline" << endl;
+            continue;
+        }
+        for (size_t p = 0; p < getPhases().size(); p++) {
+            string phase = getPhases()[p];
+            if (OBase->phases.find(phase) == OBase->phases.end() || OBase->phases[phase] <= 0) continue;
+            double ratio = OCase.phases[phase] / OBase->phases[phase];
+            bool regression = ratio > 1 + threshold && OCase.phases[phase] - OBase->phases[phase] > minimumDelta;
+            if (regression) regressions++;
+            cout << "Case " << OCase.name << " " << phase << " (" << OCase.phases[phase] << "s) baseline (" << OBase->phases[phase] << "s)";
+            cout << " ratio (" << ratio << ")" << (regression ? " REGRESSION" : "") << endl;
+        }
+    }
+    return regressions;
+}
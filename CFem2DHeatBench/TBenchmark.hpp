@@ -0,0 +1,74 @@
+//
+//  TBenchmark.hpp
+//  CFem2DHeatBench
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TBenchmark_hpp
+#define TBenchmark_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+struct SBenchCase {
+    std::string name;                       // shape-nodes, perturbed shapes end with -perturbed
+    size_t nodes;
+    size_t elements;
+    std::map<std::string, double> phases;   // seconds
+};
+
+/**
+ * Timing of every phase of a run on generated problems
+ * parse:       TInputParser::readFile
+ * kernels:     TTriangle::getKd and getF of every element
+ * assembly:    K pattern, the element contributions into K and F (kernels included)
+ *              and the boundary edges pass
+ * solve:       analyze, factorize and solve of the full system with --solver (auto by default)
+ * flux:        nodal flux estimation
+ * write:       the .post.res file
+ * The phases run one after the other (not pipelined) so they can be told
+ * apart, with --repeat=N the median of N runs is kept.
+ *
+ * The results are written as JSON and compared with a baseline, a phase
+ * slower than the baseline by more than the threshold and by more than the
+ * minimum delta (in seconds, so the timer noise of the millisecond phases is
+ * not reported) is a regression.
+ **/
+class TBenchmark {
+    private:
+        std::string directory;
+        std::vector<SBenchCase> cases;
+    
+        void runOnce(std::string fileName, std::map<std::string, double> &phases);
+    
+    public:
+        static const std::vector<std::string> & getPhases();
+    
+        TBenchmark(std::string directory);
+        virtual ~TBenchmark();
+    
+        void run(std::string shape, size_t amountOfNodes, bool perturbed, size_t repeat, bool keep);
+        void printReport();
+        void writeJson(std::string fileName);
+        static std::vector<SBenchCase> readJson(std::string fileName);
+        size_t compare(std::vector<SBenchCase> &baseline, double threshold, double minimumDelta);
+};
+
+#endif /* TBenchmark_hpp */
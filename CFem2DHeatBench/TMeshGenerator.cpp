@@ -0,0 +1,138 @@
+//
+//  TMeshGenerator.cpp
+//  CFem2DHeatBench
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "TMeshGenerator.hpp"
+
+#include <math.h>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+TMeshGenerator::TMeshGenerator(string shape, size_t amountOfNodes, bool perturbed, unsigned int seed) : shape(shape), perturbed(perturbed) {
+    if (shape == "rectangle") buildRectangle(amountOfNodes, seed);
+    else if (shape == "annulus") buildAnnulus(amountOfNodes, seed);
+    else throw runtime_error("ERROR: Unknown shape " + shape + ".");
+}
+
+TMeshGenerator::~TMeshGenerator() { }
+
+void TMeshGenerator::buildRectangle(size_t amountOfNodes, unsigned int seed) {
+    size_t ny = max((size_t)1, (size_t)round(sqrt(amountOfNodes / 2.0)) - 1);
+    size_t nx = 2 * ny;
+    mt19937 random(seed);
+    uniform_real_distribution<double> jitter(-0.25, 0.25);
+    for (size_t j = 0; j <= ny; j++) {
+        for (size_t i = 0; i <= nx; i++) {
+            SNode ONode;
+            ONode.x = 2.0 * i / nx;
+            ONode.y = 1.0 * j / ny;
+            if (perturbed && i > 0 && i < nx && j > 0 && j < ny) {
+                ONode.x += jitter(random) * 2.0 / nx;
+                ONode.y += jitter(random) * 1.0 / ny;
+            }
+            nodes.push_back(ONode);
+            size_t id = nodes.size();
+            if (i == 0) conditions["Temperature"].push_back(id);
+            else if (i == nx) conditions["Flux"].push_back(id);
+            else if (j == ny) conditions["Convection"].push_back(id);
+        }
+    }
+    for (size_t j = 0; j < ny; j++) {
+        for (size_t i = 0; i < nx; i++) {
+            size_t a = j * (nx + 1) + i + 1, b = a + 1, c = b + nx + 1, d = a + nx + 1;
+            size_t material = (i < nx / 2) ? 2 : 1;
+            triangles.push_back({a, b, c, material});
+            triangles.push_back({a, c, d, material});
+        }
+    }
+}
+
+void TMeshGenerator::buildAnnulus(size_t amountOfNodes, unsigned int seed) {
+    size_t nr = max((size_t)1, (size_t)round(sqrt(amountOfNodes / (3 * M_PI))));
+    size_t nt = max((size_t)8, amountOfNodes / (nr + 1));
+    mt19937 random(seed);
+    uniform_real_distribution<double> jitter(-0.25, 0.25);
+    for (size_t j = 0; j <= nr; j++) {
+        for (size_t i = 0; i < nt; i++) {
+            double radius = 1.0 + 1.0 * j / nr;
+            double angle = 2 * M_PI * i / nt;
+            if (perturbed && j > 0 && j < nr) {
+                radius += jitter(random) * 1.0 / nr;
+                angle += jitter(random) * 2 * M_PI / nt;
+            }
+            SNode ONode;
+            ONode.x = radius * cos(angle);
+            ONode.y = radius * sin(angle);
+            nodes.push_back(ONode);
+            size_t id = nodes.size();
+            if (j == 0) conditions["Temperature"].push_back(id);
+            else if (j == nr) conditions[(ONode.y >= 0) ? "Convection" : "Flux"].push_back(id);
+        }
+    }
+    for (size_t j = 0; j < nr; j++) {
+        for (size_t i = 0; i < nt; i++) {
+            size_t a = j * nt + i + 1, b = j * nt + (i + 1) % nt + 1, c = b + nt, d = a + nt;
+            size_t material = (nodes[a - 1].x < 0) ? 2 : 1;
+            triangles.push_back({a, b, c, material});
+            triangles.push_back({a, c, d, material});
+        }
+    }
+}
+
+void TMeshGenerator::write(string fileName) {
+    FILE *outFile = fopen(fileName.c_str(), "w");
+    if (outFile == NULL) throw runtime_error("ERROR: Cannot write the file " + fileName + ".");
+    fprintf(outFile, "Geometry Unit:\nM\n\n");
+    fprintf(outFile, "Number of Elements & Nodes:\n%zu %zu\n\n", triangles.size(), nodes.size());
+    fprintf(outFile, "Begin Materials\nN. Materials = 2\n  Mat. k h\n");
+    fprintf(outFile, "%10d %20.5e %20.5e\n", 1, 1.0, 10.0);
+    fprintf(outFile, "%10d %20.5e %20.5e\n\n", 2, 5.0, 20.0);
+    
+    fprintf(outFile, "Point conditions\n0\nTemperature\n  Node Temp\n\n");
+    const char *types[] = {"Temperature", "Flux", "Convection"};
+    const char *headers[] = {"  Node Temp", "  Node Flux", "  Node Temp"};
+    const double values[] = {100.0, -50.0, 20.0};
+    for (size_t t = 0; t < 3; t++) {
+        vector<size_t> &ids = conditions[types[t]];
+        fprintf(outFile, "Line conditions\n%zu\n%s\n%s\n", ids.size(), types[t], headers[t]);
+        for (size_t i = 0; i < ids.size(); i++) fprintf(outFile, "%10zu %13.5e\n", ids[i], values[t]);
+        fprintf(outFile, "\n");
+    }
+    
+    fprintf(outFile, "Coordinates:\n  Node X Y\n");
+    for (size_t i = 0; i < nodes.size(); i++) fprintf(outFile, "%10zu %14.6e %14.6e\n", i + 1, (double)nodes[i].x, (double)nodes[i].y);
+    fprintf(outFile, "\nConnectivities:\n  Element N1 N2 N3 Mat\n");
+    for (size_t e = 0; e < triangles.size(); e++) {
+        vector<size_t> &t = triangles[e];
+        fprintf(outFile, "%10zu%10zu%10zu%10zu%10zu\n", e + 1, t[0], t[1], t[2], t[3]);
+    }
+    fclose(outFile);
+}
+
+size_t TMeshGenerator::getAmountOfNodes() {
+    return nodes.size();
+}
+
+size_t TMeshGenerator::getAmountOfElements() {
+    return triangles.size();
+}
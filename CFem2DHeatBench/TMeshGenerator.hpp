@@ -0,0 +1,62 @@
+//
+//  TMeshGenerator.hpp
+//  CFem2DHeatBench
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TMeshGenerator_hpp
+#define TMeshGenerator_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "TElement.hpp"
+
+/**
+ * Synthetic problems in the GiD input format (what the .bas template writes)
+ * rectangle: 2 x 1, fixed temperature on the left side, flux on the right
+ *            one and convection on the top one
+ * annulus:   radius 1 to 2, fixed temperature on the inner circle,
+ *            convection on the upper half of the outer one and flux on the rest
+ * A structured grid is split in triangles, perturbed moves the interior
+ * nodes up to a quarter of a cell at random (same seed, same mesh).
+ * There are two materials, the left half of the domain is the second one.
+ **/
+class TMeshGenerator {
+    private:
+        std::string shape;
+        bool perturbed;
+        std::vector<SNode> nodes;
+        std::vector<std::vector<size_t> > triangles;    // node ids and material
+        std::map<std::string, std::vector<size_t> > conditions;
+    
+        void buildRectangle(size_t amountOfNodes, unsigned int seed);
+        void buildAnnulus(size_t amountOfNodes, unsigned int seed);
+    
+    public:
+        TMeshGenerator(std::string shape, size_t amountOfNodes, bool perturbed, unsigned int seed = 1);
+        virtual ~TMeshGenerator();
+    
+        void write(std::string fileName);
+        size_t getAmountOfNodes();
+        size_t getAmountOfElements();
+};
+
+#endif /* TMeshGenerator_hpp */
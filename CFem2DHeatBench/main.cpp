@@ -0,0 +1,78 @@
+//
+//  main.cpp
+//  CFem2DHeatBench
+//
+//  Created by Blas Eugenio Vicco on 10/19/26.
+//  Copyright © 2017 Blas Eugenio Vicco. All rights reserved.
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <iostream>
+#include <sstream>
+
+#include "TBenchmark.hpp"
+#include "TCommandLine.hpp"
+#include "TMeshGenerator.hpp"
+
+using namespace std;
+
+/**
+ * Benchmark of the CFem2DHeat phases on generated meshes
+ * CFem2DHeatBench [--sizes=1000,10000,100000] [--shapes=rectangle,annulus] [--repeat=3]
+ *                 [--output=bench.json] [--baseline=<json>] [--threshold=0.1] [--min-delta=0.01] [--dir=.] [--keep]
+ * CFem2DHeatBench --generate=<file.dat> [--shape=rectangle] [--nodes=10000] [--perturbed]
+ * Every shape runs structured and perturbed, the exit code is 1 when a phase
+ * is slower than the baseline by more than the threshold and the minimum delta (seconds)
+ **/
+int main(int argc, const char * argv[]) {
+    TCommandLine::parse(argc, argv);
+    
+    try {
+        if (TCommandLine::hasOption("generate")) {
+            TMeshGenerator generator(TCommandLine::getOption("shape", "rectangle"), (size_t)TCommandLine::getOption("nodes", 10000.0), TCommandLine::hasOption("perturbed"), (unsigned int)TCommandLine::getOption("seed", 1.0));
+            generator.write(TCommandLine::getOption("generate", ""));
+            cout << "Generated nodes (" << generator.getAmountOfNodes() << ") elements (" << generator.getAmountOfElements() << ")" << endl;
+            return 0;
+        }
+        
+        TBenchmark benchmark(TCommandLine::getOption("dir", "."));
+        size_t repeat = (size_t)TCommandLine::getOption("repeat", 3.0);
+        string size, shape;
+        stringstream shapes(TCommandLine::getOption("shapes", "rectangle,annulus"));
+        while (getline(shapes, shape, ',')) {
+            stringstream sizes(TCommandLine::getOption("sizes", "1000,10000,100000"));
+            while (getline(sizes, size, ',')) {
+                for (int perturbed = 0; perturbed < 2; perturbed++) {
+                    cout << "Running " << shape << " nodes (" << size << ")" << (perturbed ? " perturbed" : "") << "..." << endl;
+                    benchmark.run(shape, (size_t)atof(size.c_str()), perturbed, repeat, TCommandLine::hasOption("keep"));
+                }
+            }
+        }
+        benchmark.printReport();
+        benchmark.writeJson(TCommandLine::getOption("output", "bench.json"));
+        
+        if (TCommandLine::hasOption("baseline")) {
+            vector<SBenchCase> baseline = TBenchmark::readJson(TCommandLine::getOption("baseline", ""));
+            size_t regressions = benchmark.compare(baseline, TCommandLine::getOption("threshold", 0.1), TCommandLine::getOption("min-delta", 0.01));
+            cout << "Regressions (" << regressions << ")" << endl;
+            if (regressions > 0) return 1;
+        }
+    } catch (exception &e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    
+    return 0;
+}
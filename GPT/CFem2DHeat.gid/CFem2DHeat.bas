@@ -89,3 +89,15 @@ Connectivities:
 *format "%10i%10i%10i%10i%10i"
 *ElemsNum *ElemsConec *ElemsMat 
 *end elems
+
+.................................................................
+
+Substructures:
+*set Cond Surface_Substructure *elems
+*set var NSUB(int)=CondNumEntities(int)
+*NSUB
+   Element  Substructure
+*loop elems *OnlyInCond
+*format "%10i%10i"
+*ElemsNum *cond(1,int)
+*end elems